@@ -33,6 +33,11 @@
  * \brief Signal processing filtering using the CODAL DataSink and DataSource system.
  */
 
+/**
+ * @namespace Runner
+ * \brief Command line utility to run algorithms on many mazes in parallel
+ */
+
 /**
  * @namespace Simulator
  * \brief Desktop-based algorithm Simulator and remote control and debugging for Firmware
@@ -0,0 +1,62 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "Allocations.h"
+
+namespace Benchmarks::Allocations
+{
+
+static std::atomic<uint64_t> count{0};
+static std::atomic<size_t> live{0};
+static std::atomic<size_t> peak{0};
+
+// Every allocation is prefixed by its size so the live bytes can be tracked on delete, keeping the
+// alignment given by malloc
+static constexpr size_t HEADER_SIZE{alignof(std::max_align_t)};
+
+static void *Allocate(size_t size)
+{
+    auto *block{static_cast<unsigned char *>(std::malloc(size + HEADER_SIZE))};
+    if (!block)
+        throw std::bad_alloc();
+    *reinterpret_cast<size_t *>(block) = size;
+
+    count.fetch_add(1, std::memory_order_relaxed);
+    size_t now{live.fetch_add(size, std::memory_order_relaxed) + size};
+    size_t previous{peak.load(std::memory_order_relaxed)};
+    while (now > previous && !peak.compare_exchange_weak(previous, now, std::memory_order_relaxed))
+    {
+    }
+
+    return block + HEADER_SIZE;
+}
+
+static void Free(void *pointer) noexcept
+{
+    if (!pointer)
+        return;
+
+    auto *block{static_cast<unsigned char *>(pointer) - HEADER_SIZE};
+    live.fetch_sub(*reinterpret_cast<size_t *>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+uint64_t Count() noexcept { return count.load(std::memory_order_relaxed); }
+
+size_t Live() noexcept { return live.load(std::memory_order_relaxed); }
+
+size_t Peak() noexcept { return peak.load(std::memory_order_relaxed); }
+
+void ResetPeak() noexcept { peak.store(live.load(std::memory_order_relaxed)); }
+
+} // namespace Benchmarks::Allocations
+
+// Replacements of the global allocation functions, the nothrow variants of the standard library
+// forward to these
+void *operator new(size_t size) { return Benchmarks::Allocations::Allocate(size); }
+void *operator new[](size_t size) { return Benchmarks::Allocations::Allocate(size); }
+void operator delete(void *pointer) noexcept { Benchmarks::Allocations::Free(pointer); }
+void operator delete[](void *pointer) noexcept { Benchmarks::Allocations::Free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { Benchmarks::Allocations::Free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { Benchmarks::Allocations::Free(pointer); }
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Benchmarks
+{
+
+/*! \brief Counters of the heap allocations done by the whole program
+ *
+ *  The global operator new and delete are replaced in Allocations.cpp to keep track of the amount
+ * of allocations and the bytes allocated, so the allocations and peak memory of a benchmark can be
+ * measured without any external tools
+ */
+namespace Allocations
+{
+
+//! Get the amount of allocations done since the program started
+uint64_t Count() noexcept;
+//! Get the bytes currently allocated
+size_t Live() noexcept;
+//! Get the most bytes allocated at once since the last ResetPeak
+size_t Peak() noexcept;
+//! Reset the peak to the bytes currently allocated
+void ResetPeak() noexcept;
+
+} // namespace Allocations
+
+} // namespace Benchmarks
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <chrono>
+
+#include <fmt/format.h>
+
+#include <Algorithms/FloodFill.h>
+#include <Algorithms/WeightedFloodFill.h>
+#include <Core/Algorithm.h>
+#include <Core/MazeBitboard.h>
+#include <Core/MazeGenerator.h>
+#include <Core/Simulation.h>
+#include <Core/WavefrontFlood.h>
+
+#include "Allocations.h"
+#include "Benchmarks.h"
+
+using namespace Core;
+
+namespace Benchmarks
+{
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t Nanoseconds(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Escape a string for use inside of a JSON string
+static std::string Escape(std::string_view text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += fmt::format("\\{}", c);
+        else if (static_cast<unsigned char>(c) < 0x20)
+            escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+static std::string LatencyJson(const Latency &latency)
+{
+    return fmt::format(R"({{"samples": {}, "mean": {:.1f}, "p50": {}, "p99": {}, "max": {}}})",
+                       latency.samples, latency.mean, latency.p50, latency.p99, latency.max);
+}
+
+Latency Latency::FromSamples(std::span<uint64_t> samples)
+{
+    Latency latency{.samples = samples.size()};
+    if (samples.empty())
+        return latency;
+
+    std::sort(samples.begin(), samples.end());
+
+    uint64_t total{0};
+    for (auto sample : samples)
+        total += sample;
+
+    latency.mean = static_cast<double>(total) / samples.size();
+    latency.p50 = samples[samples.size() / 2];
+    latency.p99 = samples[std::min(samples.size() - 1, (samples.size() * 99) / 100)];
+    latency.max = samples.back();
+    return latency;
+}
+
+BenchmarkSuite::BenchmarkSuite(Options options) : options{std::move(options)}
+{
+    if (this->options.algorithms.empty())
+    {
+        for (auto const &entry : AlgorithmRegistry::GetRegistry())
+            this->options.algorithms.emplace_back(entry.name);
+    }
+}
+
+void BenchmarkSuite::Run()
+{
+    algorithm_results.clear();
+    flood_results.clear();
+
+    for (int size : options.sizes)
+    {
+        // Every size uses the same seed, so a size always benchmarks the same maze
+        MazeGenerator generator{options.seed};
+        auto maze{generator.Generate(
+            size, size, MazeGenerator::Options{.loops = options.loops, .contest = true})};
+
+        for (auto const &algorithm : options.algorithms)
+        {
+            fmt::print(stderr, "Benchmarking {} on {}x{}\n", algorithm, size, size);
+            algorithm_results.push_back(RunAlgorithm(algorithm, *maze));
+        }
+
+        fmt::print(stderr, "Benchmarking floods on {}x{}\n", size, size);
+        RunFloods(*maze);
+    }
+}
+
+BenchmarkSuite::AlgorithmResult BenchmarkSuite::RunAlgorithm(const std::string &algorithm,
+                                                             Maze &maze)
+{
+    AlgorithmResult result{.algorithm = algorithm,
+                           .size = maze.GetWidth(),
+                           .result = {},
+                           .steps = 0,
+                           .explored = 0,
+                           .time = 0.0,
+                           .step_ns = {},
+                           .algorithm_step_ns = {},
+                           .allocations = 0,
+                           .allocations_per_step = 0.0,
+                           .peak_bytes = 0,
+                           .error = {}};
+
+    try
+    {
+        // Reserved up front so storing the samples never allocates during the run
+        std::vector<uint64_t> samples;
+        samples.reserve(options.max_steps);
+
+        Allocations::ResetPeak();
+        size_t live{Allocations::Live()};
+
+        Simulation simulation{std::make_unique<Maze>(maze)};
+        if (!simulation.Reset(algorithm))
+        {
+            result.error = "Unable to set algorithm";
+            return result;
+        }
+
+        // Macro benchmark of a whole run
+        uint64_t allocations{Allocations::Count()};
+        auto deadline{Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                         std::chrono::duration<double>(options.max_seconds))};
+
+        Simulation::StepResult step_result{Simulation::StepResult::Invalid};
+        for (uint64_t i{0}; i < options.max_steps; ++i)
+        {
+            auto start{Clock::now()};
+            step_result = simulation.Step();
+            auto end{Clock::now()};
+
+            samples.push_back(Nanoseconds(start, end));
+            if (step_result != Simulation::StepResult::Moved || end > deadline)
+                break;
+        }
+
+        result.allocations = Allocations::Count() - allocations;
+        result.peak_bytes = Allocations::Peak() - live;
+        result.result = Simulation::GetStepResultString(step_result);
+        result.steps = simulation.GetSteps();
+        result.explored = simulation.GetExplored();
+        result.time = simulation.GetTime();
+        result.allocations_per_step =
+            static_cast<double>(result.allocations) / std::max(result.steps, uint64_t(1));
+        result.step_ns = Latency::FromSamples(samples);
+
+        // Micro benchmark of Algorithm::Step on a spread of tiles of the explored maze
+        Mouse *mouse{simulation.GetMouse()};
+        Algorithm *instance{mouse->GetAlgorithm()};
+        int tiles{maze.GetWidth() * maze.GetHeight()};
+        int count{std::min(tiles, 256)};
+
+        samples.clear();
+        for (int repeat{0}; repeat < options.repeats; ++repeat)
+        {
+            for (int i{0}; i < count; ++i)
+            {
+                // Stride by a prime to spread the tiles over the whole maze
+                int tile{static_cast<int>((static_cast<int64_t>(i) * 7919) % tiles)};
+                int x{tile % maze.GetWidth()};
+                int y{tile / maze.GetWidth()};
+
+                auto start{Clock::now()};
+                instance->Step(mouse, x, y, Direction::Up);
+                samples.push_back(Nanoseconds(start, Clock::now()));
+            }
+        }
+        result.algorithm_step_ns = Latency::FromSamples(samples);
+    }
+    catch (const std::exception &e)
+    {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+void BenchmarkSuite::RunFloods(Maze &maze)
+{
+    int width{maze.GetWidth()};
+    int height{maze.GetHeight()};
+    std::vector<uint64_t> samples;
+
+    // Time \p flood over every repeat
+    auto run{[&](std::string name, auto flood)
+             {
+                 samples.clear();
+                 for (int repeat{0}; repeat < options.repeats; ++repeat)
+                 {
+                     auto start{Clock::now()};
+                     flood();
+                     samples.push_back(Nanoseconds(start, Clock::now()));
+                 }
+                 flood_results.push_back(FloodResult{.name = std::move(name),
+                                                     .size = width,
+                                                     .flood_ns = Latency::FromSamples(samples)});
+             }};
+
+    Algorithms::FloodFill flood_fill{nullptr, width, height};
+    run("FloodFill", [&]() { flood_fill.Flood(&maze, false); });
+
+    Algorithms::WeightedFloodFill weighted{nullptr, width, height};
+    run("WeightedFloodFill", [&]() { weighted.Flood(&maze, false); });
+
+    // The walls are converted once, as an Algorithm would keep its bitboard up to date
+    WavefrontFlood wavefront{width, height};
+    wavefront.SetWalls(MazeBitboard(maze));
+    run("WavefrontFlood", [&]() { wavefront.Flood(false); });
+}
+
+std::string BenchmarkSuite::ToJson() const
+{
+    std::string json;
+    json += "{\n";
+    json += fmt::format("  \"seed\": {},\n", options.seed);
+    json += fmt::format("  \"loops\": {},\n", options.loops);
+    json += fmt::format("  \"repeats\": {},\n", options.repeats);
+
+    json += "  \"algorithms\": [\n";
+    for (size_t i{0}; i < algorithm_results.size(); ++i)
+    {
+        auto &result{algorithm_results[i]};
+        json += fmt::format(
+            "    {{\"algorithm\": \"{}\", \"size\": {}, \"result\": \"{}\", \"steps\": {}, "
+            "\"explored\": {}, \"time\": {:.3f}, \"step_ns\": {}, \"algorithm_step_ns\": {}, "
+            "\"allocations\": {}, \"allocations_per_step\": {:.3f}, \"peak_bytes\": {}, "
+            "\"error\": \"{}\"}}{}\n",
+            Escape(result.algorithm), result.size, result.result, result.steps, result.explored,
+            result.time, LatencyJson(result.step_ns), LatencyJson(result.algorithm_step_ns),
+            result.allocations, result.allocations_per_step, result.peak_bytes,
+            Escape(result.error), i + 1 < algorithm_results.size() ? "," : "");
+    }
+    json += "  ],\n";
+
+    json += "  \"floods\": [\n";
+    for (size_t i{0}; i < flood_results.size(); ++i)
+    {
+        auto &result{flood_results[i]};
+        json += fmt::format("    {{\"name\": \"{}\", \"size\": {}, \"flood_ns\": {}}}{}\n",
+                            result.name, result.size, LatencyJson(result.flood_ns),
+                            i + 1 < flood_results.size() ? "," : "");
+    }
+    json += "  ]\n";
+    json += "}\n";
+
+    return json;
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <Core/Maze.h>
+
+namespace Benchmarks
+{
+
+//! Distribution of the samples of a timed operation in nanoseconds
+struct Latency
+{
+    uint64_t samples{0};
+    double mean{0.0};
+    uint64_t p50{0};
+    uint64_t p99{0};
+    uint64_t max{0};
+
+    //! Summarize the \p samples, reordering them
+    static Latency FromSamples(std::span<uint64_t> samples);
+};
+
+/*! \brief Benchmarks of every algorithm across maze sizes
+ *
+ *  Mazes are generated with Core::MazeGenerator from the seed, so every run benchmarks the same
+ * mazes. For every algorithm and maze size it measures:
+ *  - Macro: a complete Core::Simulation run to the goal, timing every Core::Simulation::Step and
+ *    counting the allocations and peak heap memory of the run
+ *  - Micro: Core::Algorithm::Step alone on the explored maze, without any walls changing
+ *
+ *  For every maze size it also measures a full flood of the known maze with FloodFill,
+ * WeightedFloodFill and Core::WavefrontFlood.
+ */
+class BenchmarkSuite
+{
+public:
+    struct Options
+    {
+        uint64_t seed{1};
+        std::vector<int> sizes{8, 16, 32, 64, 128, 256};
+        //! Fraction of walls removed to add loops to the generated mazes
+        float loops{0.1f};
+        //! Maximum steps of every simulation run
+        uint64_t max_steps{1'000'000};
+        //! Stop a simulation run after this many seconds of stepping
+        double max_seconds{10.0};
+        //! Amount of times every micro benchmark is repeated
+        int repeats{10};
+        //! Only benchmark these algorithms, defaults to every algorithm in Core::AlgorithmRegistry
+        std::vector<std::string> algorithms{};
+    };
+
+    //! Result of an algorithm on a maze size
+    struct AlgorithmResult
+    {
+        std::string algorithm;
+        int size;
+        std::string result;
+        uint64_t steps{0};
+        uint64_t explored{0};
+        //! Virtual time in seconds of the run, see Core::Simulation
+        double time{0.0};
+        //! Time of every Core::Simulation::Step, including the simulated sensors
+        Latency step_ns;
+        //! Time of Core::Algorithm::Step alone when no walls change
+        Latency algorithm_step_ns;
+        uint64_t allocations{0};
+        double allocations_per_step{0.0};
+        //! Most heap bytes in use during the run above the bytes in use before it
+        size_t peak_bytes{0};
+        std::string error{};
+    };
+
+    //! Result of a full flood on a maze size
+    struct FloodResult
+    {
+        std::string name;
+        int size;
+        Latency flood_ns;
+    };
+
+    BenchmarkSuite(Options options);
+
+    //! Run every benchmark
+    void Run();
+    //! Get the results of the last Run as JSON
+    std::string ToJson() const;
+
+private:
+    Options options;
+    std::vector<AlgorithmResult> algorithm_results;
+    std::vector<FloodResult> flood_results;
+
+    //! Run the \p algorithm on a copy of the \p maze
+    AlgorithmResult RunAlgorithm(const std::string &algorithm, Core::Maze &maze);
+    //! Time a full flood of the \p maze with every flood fill
+    void RunFloods(Core::Maze &maze);
+};
+
+} // namespace Benchmarks
@@ -0,0 +1,81 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Benchmarks.h"
+
+void PrintUsage(const std::string &program)
+{
+    fmt::println("Usage: {} [options]", program);
+    fmt::println("  --output <path>    Write the JSON results to the file instead of stdout");
+    fmt::println("  --seed <n>         Seed of the generated mazes (default 1)");
+    fmt::println("  --size <n>         Benchmark the maze size, can be repeated (default 8-256)");
+    fmt::println("  --algorithm <name> Only benchmark the algorithm, can be repeated");
+    fmt::println("  --repeats <n>      Repeats of every micro benchmark (default 10)");
+    fmt::println("  --steps <n>        Maximum steps per run (default 1000000)");
+    fmt::println("  --seconds <n>      Maximum seconds per run (default 10)");
+}
+
+int main(int argc, char *argv[])
+{
+    // Read the args from argv
+    std::vector<std::string> args{argv, argv + argc};
+
+    Benchmarks::BenchmarkSuite::Options options{};
+    std::vector<int> sizes;
+    std::string output_path;
+
+    try
+    {
+        for (size_t i{1}; i < args.size(); ++i)
+        {
+            if (args[i] == "--output" && i + 1 < args.size())
+                output_path = args[++i];
+            else if (args[i] == "--seed" && i + 1 < args.size())
+                options.seed = std::stoull(args[++i]);
+            else if (args[i] == "--size" && i + 1 < args.size())
+                sizes.push_back(std::stoi(args[++i]));
+            else if (args[i] == "--algorithm" && i + 1 < args.size())
+                options.algorithms.push_back(args[++i]);
+            else if (args[i] == "--repeats" && i + 1 < args.size())
+                options.repeats = std::stoi(args[++i]);
+            else if (args[i] == "--steps" && i + 1 < args.size())
+                options.max_steps = std::stoull(args[++i]);
+            else if (args[i] == "--seconds" && i + 1 < args.size())
+                options.max_seconds = std::stod(args[++i]);
+            else
+            {
+                PrintUsage(args[0]);
+                return 1;
+            }
+        }
+
+        if (!sizes.empty())
+            options.sizes = sizes;
+
+        Benchmarks::BenchmarkSuite suite{options};
+        suite.Run();
+
+        if (output_path.empty())
+        {
+            fmt::print("{}", suite.ToJson());
+        }
+        else
+        {
+            std::ofstream output(output_path);
+            if (!output)
+                throw std::runtime_error(fmt::format("Error opening file at: {}", output_path));
+            output << suite.ToJson();
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,12 +1,23 @@
 #pragma once
 
-#include <functional>
-#include <map>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 
 #include "Maze.h"
 
+#ifdef FIRMWARE
+// Bytes of static storage the Algorithm is constructed in for firmware builds, fitting FloodFill
+// which is the largest registered in firmware, REGISTER_ALGORITHM checks every Algorithm fits
+#ifndef ALGORITHM_STORAGE_SIZE
+#define ALGORITHM_STORAGE_SIZE (5 * 1024)
+#endif
+#endif
+
 namespace Core
 {
 // Forward-decl
@@ -30,26 +41,69 @@ public:
 
 /*! \brief Registry class for algorithms
  *
- *  The registry enables algorithms to be registered in a static variable
+ *  The registry enables algorithms to be registered in a static variable. The algorithms are kept
+ * in a flat table sorted by name, so the index of an algorithm is the same in every build with the
+ * same algorithms. Lookup by index is a table access and lookup by name uses a small hash table,
+ * neither allocates.
  */
 class AlgorithmRegistry
 {
 public:
-    using AlgorithmConstructor = std::function<Algorithm *(Mouse *mouse, int x, int y)>;
-    using Registry = std::map<std::string, AlgorithmConstructor>;
+    using AlgorithmConstructor = Algorithm *(*)(Mouse *mouse, int width, int height);
+
+    //! A registered Algorithm
+    struct Entry
+    {
+        std::string_view name;
+        AlgorithmConstructor constructor;
+    };
+    //! The registered algorithms, indexed by algorithm index
+    using Registry = std::span<const Entry>;
+
+    //! Max amount of algorithms that can be registered
+    static constexpr size_t MAX_ALGORITHMS{16};
+
+    //! Destroys an Algorithm constructed by the registry
+    struct Deleter
+    {
+        void operator()(Algorithm *algorithm) const;
+    };
+    //! Owning pointer to an Algorithm constructed by the registry
+    using Pointer = std::unique_ptr<Algorithm, Deleter>;
 
     //! Algorithm registration function, used internally by REGISTER_ALGORITHM macro
     //!
     //! \attention Do not call after static initialization, that will screw the algorithm indexes!
-    static bool Register(const std::string &name, AlgorithmConstructor constructor);
+    //! \attention The \p name must outlive the registry, like a string literal
+    //! \returns Returns false if the registry is full
+    static bool Register(std::string_view name, AlgorithmConstructor constructor);
     //! Access the registry of Algorithm registrated
-    static Registry &GetRegistry();
+    static Registry GetRegistry() noexcept;
+    //! Get the Algorithm at \p index, nullptr if out of range
+    static const Entry *Get(size_t index) noexcept;
+    //! Find the index of the Algorithm named \p name
+    static std::optional<size_t> Find(std::string_view name) noexcept;
+#ifdef FIRMWARE
+    //! \brief Get the static storage every Algorithm is constructed in
+    //!
+    //! \attention Only a single Algorithm can exist at a time
+    static void *GetStorage();
+#endif
 };
 
 } // namespace Core
 
 // Add register macro for algorithms
+#ifdef FIRMWARE
+#define REGISTER_ALGORITHM(ALGORITHM)                                                              \
+    static_assert(sizeof(ALGORITHM) <= ALGORITHM_STORAGE_SIZE,                                     \
+                  "ALGORITHM_STORAGE_SIZE is too small for " #ALGORITHM);                          \
+    bool ALGORITHM##Algorithm = AlgorithmRegistry::Register(                                       \
+        #ALGORITHM, [](Mouse *mouse, int x, int y) -> Algorithm *                                  \
+        { return new (AlgorithmRegistry::GetStorage()) ALGORITHM(mouse, x, y); });
+#else
 #define REGISTER_ALGORITHM(ALGORITHM)                                                              \
     bool ALGORITHM##Algorithm = AlgorithmRegistry::Register(                                       \
         #ALGORITHM,                                                                                \
         [](Mouse *mouse, int x, int y) -> Algorithm * { return new ALGORITHM(mouse, x, y); });
+#endif
@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "Profiler.h"
+
 //! Macro to create the MicroBit BLE UUID for SimpleBLE
 #define MICROBIT_BLE_UUID(uuid) fmt::format("e95d{:04x}-251d-470a-a062-fa1922dfa9a8", uuid)
 //! Get the namespaced ident for BLE structure for service
@@ -97,6 +99,7 @@ enum class Characteristics : uint8_t
     GetAlgorithmName,
     Position,
     Maze,
+    Profile,
     Count,
 };
 IMPL_CHARACTERISTIC(Characteristics)
@@ -108,7 +111,8 @@ using AlgorithmCount = uint16_t;
 enum class MouseAction : uint8_t
 {
     Reset = 0,
-    Step
+    Step,
+    ClearProfile
 };
 
 //! Struct holding information about updating mouse parameters
@@ -130,6 +134,9 @@ struct MousePosition
     bool moving;
 };
 
+//! Statistics of every Core::Profiler probe, indexed by Core::Profiler::Probe
+using Profile = std::array<Core::Profiler::Stats, Core::Profiler::PROBE_COUNT>;
+
 }; // namespace MouseService
 
 }; // namespace Core::Comm
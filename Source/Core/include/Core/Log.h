@@ -1,13 +1,141 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
 #include <fmt/format.h>
 
+// Highest LogLevel compiled in, the macros of the levels above are removed
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL 4
+#endif
+
 namespace Core
 {
 
+//! Wire format of the deferred log records written by Firmware and read by the LogDecoder
+namespace LogRecord
+{
+
+//! First byte of every record, used to find the start of a record in the stream
+const uint8_t SYNC{0xA5};
+//! Sync, payload size, flags, format id and timestamp
+const size_t HEADER_SIZE{11};
+//! Largest payload of a record
+const size_t MAX_PAYLOAD{255};
+//! Longest string argument, longer strings are cut
+const size_t MAX_STRING{32};
+//! Format id of the record telling how many records were dropped, with a single UInt32 argument
+const uint32_t DROPPED_ID{0};
+//! Bit of the flags set if a newline follows the text, the lower bits hold the LogLevel
+const uint8_t NEWLINE{0x80};
+
+//! Type of an argument, written before the value
+enum class ArgType : uint8_t
+{
+    Bool = 0,
+    Int32,
+    UInt32,
+    Int64,
+    UInt64,
+    Float,
+    Double,
+    //! Length byte followed by the characters
+    String,
+};
+
+//! Get the format id of \p format, 32-bit FNV-1a of the text
+constexpr uint32_t FormatId(std::string_view format)
+{
+    uint32_t hash{2166136261u};
+    for (char c : format)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//! Encode \p value as an argument into \p out, which is advanced past it
+template <typename T> inline void EncodeArg(uint8_t *&out, const T &value)
+{
+    auto write{[&out](ArgType type, const void *data, size_t size)
+               {
+                   *out++ = static_cast<uint8_t>(type);
+                   std::memcpy(out, data, size);
+                   out += size;
+               }};
+
+    if constexpr (std::is_same_v<T, bool>)
+        write(ArgType::Bool, &value, 1);
+    else if constexpr (std::is_integral_v<T> && sizeof(T) <= 4)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            int32_t v{value};
+            write(ArgType::Int32, &v, sizeof(v));
+        }
+        else
+        {
+            uint32_t v{value};
+            write(ArgType::UInt32, &v, sizeof(v));
+        }
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            int64_t v{value};
+            write(ArgType::Int64, &v, sizeof(v));
+        }
+        else
+        {
+            uint64_t v{value};
+            write(ArgType::UInt64, &v, sizeof(v));
+        }
+    }
+    else if constexpr (std::is_same_v<T, float>)
+        write(ArgType::Float, &value, sizeof(value));
+    else if constexpr (std::is_same_v<T, double>)
+        write(ArgType::Double, &value, sizeof(value));
+    else if constexpr (std::is_enum_v<T>)
+        EncodeArg(out, static_cast<std::underlying_type_t<T>>(value));
+    else
+    {
+        static_assert(std::is_convertible_v<const T &, std::string_view>,
+                      "Deferred log arguments must be numbers, bools, enums or strings");
+        std::string_view text{value};
+        size_t length{std::min(text.size(), MAX_STRING)};
+        *out++ = static_cast<uint8_t>(ArgType::String);
+        *out++ = static_cast<uint8_t>(length);
+        std::memcpy(out, text.data(), length);
+        out += length;
+    }
+}
+
+//! Get the largest encoded size of an argument of type \p T
+template <typename T> constexpr size_t MaxArgSize()
+{
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        return 1 + 8;
+    else
+        return 2 + MAX_STRING;
+}
+
+}; // namespace LogRecord
+
 /*! \brief Logger implementation for Firmware and Simulator
  *
- *  It contains a function to print pre-formatted information
+ *  It contains a function to print pre-formatted information.
+ *
+ *  In firmware builds the LOG macros are deferred: instead of formatting the text, only the
+ * LogRecord::FormatId of the format string and the raw arguments are queued, without allocating.
+ * Flush writes the queued records to serial from the main loop, and the LogDecoder tool renders
+ * the text on desktop using the format strings found in the sources.
  */
 class Logger
 {
@@ -29,15 +157,72 @@ public:
 
     //! Manually log some text at a set LogLevel with optional newline inserted
     static void Log(LogLevel level, std::string_view text, bool newline = true);
+    //! Only log at \p level and the levels of higher priority, defaults to LogLevel::Debug
+    static void SetLevel(LogLevel level);
+
+    //! Queue a record of the format string with id \p Id and the \p args, used by the LOG macros
+    template <uint32_t Id, typename... Args>
+    static void Defer(LogLevel level, bool newline, const Args &...args)
+    {
+        static_assert((LogRecord::MaxArgSize<Args>() + ... + 0) <= LogRecord::MAX_PAYLOAD,
+                      "Too many deferred log arguments");
+
+        if (level > Logger::level)
+            return;
+
+        uint8_t payload[(LogRecord::MaxArgSize<Args>() + ... + 0) + 1];
+        uint8_t *out{payload};
+        (LogRecord::EncodeArg(out, args), ...);
+
+        Push(level, newline, Id, {payload, static_cast<size_t>(out - payload)});
+    }
+
+    //! Write the queued records to serial, only writes what fits without blocking, firmware only
+    static void Flush();
+    //! Pop up to `out.size()` bytes of the queued records into \p out, returns the count popped
+    static size_t Drain(std::span<uint8_t> out);
+
+private:
+    static LogLevel level;
+
+    //! Queue a record with the encoded arguments \p payload
+    static void Push(LogLevel level, bool newline, uint32_t id, std::span<const uint8_t> payload);
 };
 
+//! Get the name of \p level padded to the same width, empty for Logger::LogLevel::None
+std::string_view GetLogLevelString(const Logger::LogLevel level);
+
 } // namespace Core
 
-// Helper macros using fmt
-#define LOG(text, ...)                                                                             \
-    Core::Logger::Log(Core::Logger::LogLevel::None, fmt::format(text, ##__VA_ARGS__), false)
-#define LOG_LEVEL(level, text, ...) Core::Logger::Log(level, fmt::format(text, ##__VA_ARGS__))
+// Helper macros using fmt, or deferred records in firmware builds
+#ifdef FIRMWARE
+#define LOG_RECORD(level, newline, text, ...)                                                      \
+    Core::Logger::Defer<Core::LogRecord::FormatId(text)>(level, newline, ##__VA_ARGS__)
+#else
+#define LOG_RECORD(level, newline, text, ...)                                                      \
+    Core::Logger::Log(level, fmt::format(text, ##__VA_ARGS__), newline)
+#endif
+
+#define LOG(text, ...) LOG_RECORD(Core::Logger::LogLevel::None, false, text, ##__VA_ARGS__)
+#define LOG_LEVEL(level, text, ...) LOG_RECORD(level, true, text, ##__VA_ARGS__)
+
+#if LOG_MAX_LEVEL >= 1
 #define LOG_ERROR(format, ...) LOG_LEVEL(Core::Logger::LogLevel::Error, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) ((void)0)
+#endif
+#if LOG_MAX_LEVEL >= 2
 #define LOG_WARN(format, ...) LOG_LEVEL(Core::Logger::LogLevel::Warn, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) ((void)0)
+#endif
+#if LOG_MAX_LEVEL >= 3
 #define LOG_INFO(format, ...) LOG_LEVEL(Core::Logger::LogLevel::Info, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) ((void)0)
+#endif
+#if LOG_MAX_LEVEL >= 4
 #define LOG_DEBUG(format, ...) LOG_LEVEL(Core::Logger::LogLevel::Debug, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) ((void)0)
+#endif
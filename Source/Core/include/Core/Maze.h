@@ -9,6 +9,17 @@
 
 #include "Bitflags.h"
 #include "Inline.h"
+#include "StaticVector.h"
+
+#ifdef FIRMWARE
+// The Maze size is fixed in firmware builds, so every Maze and tile state has a static size
+#ifndef MAZE_WIDTH
+#define MAZE_WIDTH 16
+#endif
+#ifndef MAZE_HEIGHT
+#define MAZE_HEIGHT 16
+#endif
+#endif
 
 namespace Core
 {
@@ -49,6 +60,7 @@ public:
         Backward = Down,
     };
 
+    Direction() = default;
     Direction(ValueEnum direction) : direction{direction} {}
 
     //! Get the closest direction based on rotation in degrees
@@ -99,16 +111,33 @@ private:
     ValueEnum direction{};
 };
 
+#ifdef FIRMWARE
+//! Storage of \p N values per tile of the Maze, with a fixed capacity in firmware builds
+template <typename T, size_t N = 1>
+using TileStorage = StaticVector<T, static_cast<size_t>(MAZE_WIDTH) * MAZE_HEIGHT * N>;
+#else
+//! Storage of \p N values per tile of the Maze, with a fixed capacity in firmware builds
+template <typename T, size_t N = 1> using TileStorage = std::vector<T>;
+#endif
+
 /*! \brief Grid based structure with every MazeTile
  *
- *  It keeps track of width and height and has a simple function get a tile based on position
+ *  It keeps track of width and height and has a simple function get a tile based on position.
+ *
+ *  In firmware builds the size is fixed to `MAZE_WIDTH` by `MAZE_HEIGHT` at compile time, so the
+ * tiles are stored inline and all bounds are constants
  */
 class Maze
 {
 private:
+#ifdef FIRMWARE
+    static constexpr int width{MAZE_WIDTH};
+    static constexpr int height{MAZE_HEIGHT};
+#else
     int width;
     int height;
-    std::vector<MazeTile> tiles;
+#endif
+    TileStorage<MazeTile> tiles;
 
 public:
     //! Create a empty new maze with the width and height specified
@@ -172,7 +201,7 @@ public:
     //! Get height of Maze
     inline int GetHeight() noexcept { return height; }
     //! Get alias to maze vector
-    inline const std::vector<MazeTile> &Data() noexcept { return tiles; }
+    inline const TileStorage<MazeTile> &Data() noexcept { return tiles; }
 };
 
 } // namespace Core
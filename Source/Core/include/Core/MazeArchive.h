@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Maze.h"
+
+namespace Core
+{
+
+/*! \brief Read-only archive of many mazes in a single memory-mapped file
+ *
+ *  The archive starts with a 16 byte header followed by an offset table with an entry for every
+ * maze, so any maze can be found in O(1) without reading the others. Every maze is stored in the
+ * MazeFile binary format with its name directly after it. All values are little-endian:
+ *
+ *  | Offset | Size | Value                                               |
+ *  |--------|------|-----------------------------------------------------|
+ *  | 0      | 4    | Magic `MBMA`                                        |
+ *  | 4      | 2    | Version, currently 1                                |
+ *  | 6      | 2    | Reserved, 0                                         |
+ *  | 8      | 4    | Amount of mazes                                     |
+ *  | 12     | 4    | Reserved, 0                                         |
+ *  | 16     | 16*n | Entries of offset (8), maze size (4), name size (4) |
+ *
+ *  Mazes are packed with MazeArchive::Builder, which removes duplicates including rotated and
+ * mirrored copies of the same maze.
+ *
+ *  \attention Only available in non-firmware builds
+ */
+class MazeArchive
+{
+public:
+    //! Magic bytes of the archive format
+    static constexpr std::string_view MAGIC{"MBMA"};
+    static constexpr uint16_t VERSION{1};
+    static constexpr size_t HEADER_SIZE{16};
+    static constexpr size_t ENTRY_SIZE{16};
+    //! File extension used for archives
+    static constexpr std::string_view EXTENSION{".mazes"};
+
+    //! Packs mazes into an archive, skipping duplicates
+    class Builder
+    {
+    public:
+        //! \brief Add the \p maze under \p name
+        //!
+        //! \returns Returns false if the maze or a rotated or mirrored copy of it was already added
+        bool Add(std::string_view name, Maze &maze);
+        //! Get the amount of mazes added
+        inline size_t Size() const noexcept { return entries.size(); }
+        //! Get the archive with every maze added
+        std::vector<uint8_t> ToBinary() const;
+        //! Save the archive to \p path
+        void Save(const std::filesystem::path &path) const;
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            std::vector<uint8_t> data;
+            std::vector<uint8_t> canonical;
+        };
+
+        std::vector<Entry> entries;
+        //! Indices into entries by the hash of the canonical form
+        std::unordered_multimap<uint64_t, size_t> hashes;
+    };
+
+    //! Memory-map the archive at \p path
+    MazeArchive(const std::filesystem::path &path);
+    ~MazeArchive();
+
+    MazeArchive(const MazeArchive &) = delete;
+    MazeArchive &operator=(const MazeArchive &) = delete;
+
+    //! Get the amount of mazes in the archive
+    inline size_t Size() const noexcept { return count; }
+    //! Get the name of maze \p i
+    std::string_view GetName(size_t i) const;
+    //! Get maze \p i in the MazeFile binary format, pointing into the mapped file
+    std::span<const uint8_t> GetData(size_t i) const;
+    //! Load maze \p i
+    std::unique_ptr<Maze> Load(size_t i) const;
+
+    //! \brief Get the canonical form of the \p maze in the MazeFile binary format
+    //!
+    //! The canonical form is the lowest of the eight rotations and mirrors of the \p maze, so every
+    //! rotated or mirrored copy of a maze has the same canonical form
+    static std::vector<uint8_t> Canonical(Maze &maze);
+    //! Get the FNV-1a hash of \p data
+    static uint64_t Hash(std::span<const uint8_t> data) noexcept;
+
+private:
+    struct Entry
+    {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t name_size;
+    };
+
+    //! Get the offset table entry of maze \p i
+    Entry GetEntry(size_t i) const;
+    //! Unmap and close the file
+    void Close() noexcept;
+
+    const uint8_t *data{nullptr};
+    size_t size{0};
+    size_t count{0};
+#ifdef _WIN32
+    void *file{nullptr};
+    void *mapping{nullptr};
+#endif
+};
+
+} // namespace Core
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Inline.h"
+#include "Maze.h"
+
+namespace Core
+{
+
+/*! \brief Maze storage using wall bit-planes where every wall is only stored once
+ *
+ *  The horizontal walls are stored as `height + 1` rows of `width` bits, with row y being the wall
+ * below tile y. The vertical walls are stored as `height` rows of `width + 1` bits, with bit x
+ * being the wall left of tile x. Both planes are stored in the same word array, so a 16x16 maze
+ * fits in 72 bytes and a wall query is a single bit test without any branching.
+ *
+ *  Start and goal tiles are stored in separate masks of `width * height` bits.
+ */
+class MazeBitboard
+{
+public:
+    using Word = uint64_t;
+    static constexpr int WORD_BITS{64};
+
+    /*! \brief Read-only view of a MazeBitboard as MazeTile values
+     *
+     *  Behaves like the `std::vector<MazeTile>` returned by Maze::Data(), with the tiles indexed as
+     * `(width * y) + x`
+     */
+    class TileView
+    {
+    public:
+        TileView(const MazeBitboard *bitboard) : bitboard{bitboard} {}
+
+        //! Get the amount of tiles
+        inline size_t size() const noexcept
+        {
+            return static_cast<size_t>(bitboard->width) * bitboard->height;
+        }
+        //! Get the tile at \p i, tiles are ordered by row
+        inline MazeTile operator[](size_t i) const noexcept
+        {
+            return bitboard->GetTile(static_cast<int>(i % bitboard->width),
+                                     static_cast<int>(i / bitboard->width));
+        }
+
+    private:
+        const MazeBitboard *bitboard;
+    };
+
+    //! Create an empty bitboard with the width and height specified
+    MazeBitboard(int width, int height);
+    //! Create a bitboard from the \p maze, a wall is set if any side of it is set in \p maze
+    MazeBitboard(Maze &maze);
+    //! Create a bitboard from the raw \p words, as given by Words() of a bitboard of the same size
+    MazeBitboard(int width, int height, std::span<const Word> words);
+    //! Get the count of Words() of a bitboard of \p width x \p height, without allocating it
+    static uint64_t GetWordCount(int width, int height) noexcept;
+
+    //! Check if a tile has a wall to the side
+    inline INLINE bool HasWall(int x, int y, Direction direction) const noexcept
+    {
+        return Test(WallIndex(x, y, direction));
+    }
+    //! Set or clear the wall of a tile to the side, also affecting the adjacent tile
+    inline INLINE void SetWall(int x, int y, Direction direction, bool present = true) noexcept
+    {
+        Set(WallIndex(x, y, direction), present);
+    }
+
+    //! Check if the tile is a start tile
+    inline INLINE bool IsStart(int x, int y) const noexcept { return Test(StartIndex(x, y)); }
+    //! Check if the tile is a goal tile
+    inline INLINE bool IsGoal(int x, int y) const noexcept { return Test(GoalIndex(x, y)); }
+    //! Mark the tile as a start tile
+    inline void SetStart(int x, int y, bool start = true) noexcept { Set(StartIndex(x, y), start); }
+    //! Mark the tile as a goal tile
+    inline void SetGoal(int x, int y, bool goal = true) noexcept { Set(GoalIndex(x, y), goal); }
+
+    //! Get the MazeTile at the x, y position, with walls from both sides
+    MazeTile GetTile(int x, int y) const noexcept;
+    //! Get a view of every tile, compatible with Maze::Data()
+    inline TileView Data() const noexcept { return TileView(this); }
+    //! Write the walls, start and goal tiles into the \p maze of same size
+    void CopyTo(Maze &maze) const;
+    //! Clear all the walls
+    void ResetWalls() noexcept;
+
+    //! Check if the coords are within bounds
+    inline INLINE bool WithinBounds(int x, int y) const noexcept
+    {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+    //! Get width of Maze
+    inline int GetWidth() const noexcept { return width; }
+    //! Get height of Maze
+    inline int GetHeight() const noexcept { return height; }
+    //! Get the raw words holding the wall planes and start/goal masks
+    inline const std::vector<Word> &Words() const noexcept { return words; }
+    //! Get \p count (at most 64) bits of Words() starting at bit \p index
+    inline Word GetBits(int index, int count) const noexcept
+    {
+        unsigned word{static_cast<unsigned>(index) / WORD_BITS};
+        unsigned offset{static_cast<unsigned>(index) % WORD_BITS};
+        Word bits{words[word] >> offset};
+        if (offset + count > WORD_BITS)
+            bits |= words[word + 1] << (WORD_BITS - offset);
+        return count < WORD_BITS ? bits & ((Word(1) << count) - 1) : bits;
+    }
+
+    //! \brief Get the bit index in Words() of the wall to the side of the tile
+    //!
+    //! The walls of the same side of a row of tiles are contiguous bits
+    inline INLINE int WallIndex(int x, int y, Direction direction) const noexcept
+    {
+        // Offset to the wall of the tile, Up and Right are the next row and column of walls
+        static constexpr int OFFSET_X[4] = {0, 1, 0, 0};
+        static constexpr int OFFSET_Y[4] = {1, 0, 0, 0};
+        int d{static_cast<int>(direction.Value())};
+        return base[d] + ((y + OFFSET_Y[d]) * stride[d]) + x + OFFSET_X[d];
+    }
+    //! Get the bit index in Words() of the start flag of the tile
+    inline INLINE int StartIndex(int x, int y) const noexcept
+    {
+        return start_base + (y * width) + x;
+    }
+    //! Get the bit index in Words() of the goal flag of the tile
+    inline INLINE int GoalIndex(int x, int y) const noexcept { return goal_base + (y * width) + x; }
+
+private:
+    int width;
+    int height;
+    //! Bit offset and row stride per Direction into the wall planes
+    int base[4];
+    int stride[4];
+    //! Bit offset to start and goal masks
+    int start_base;
+    int goal_base;
+    std::vector<Word> words;
+
+    inline INLINE bool Test(unsigned i) const noexcept
+    {
+        return (words[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+    }
+    inline INLINE void Set(unsigned i, bool value) noexcept
+    {
+        Word mask{Word(1) << (i % WORD_BITS)};
+        words[i / WORD_BITS] = (words[i / WORD_BITS] & ~mask) | (-Word(value) & mask);
+    }
+};
+
+} // namespace Core
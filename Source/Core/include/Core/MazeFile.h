@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Maze.h"
+
+namespace Core
+{
+
+/*! \brief Loading and saving of maze files in the ASCII and binary formats
+ *
+ *  The ASCII format draws the maze with `o` posts, `---` and `|` walls and `S`/`G` in the center of
+ * start and goal tiles, with the first line being the top of the maze.
+ *
+ *  The binary format is a 16 byte header followed by the words of a MazeBitboard, so it is loaded
+ * with a single read and no per-tile parsing. All values are little-endian:
+ *
+ *  | Offset | Size | Value                           |
+ *  |--------|------|---------------------------------|
+ *  | 0      | 4    | Magic `MBMZ`                    |
+ *  | 4      | 2    | Version, currently 1            |
+ *  | 6      | 2    | Width                           |
+ *  | 8      | 2    | Height                          |
+ *  | 10     | 2    | Reserved, 0                     |
+ *  | 12     | 4    | Amount of 64-bit words          |
+ *  | 16     | 8*n  | MazeBitboard::Words()           |
+ *
+ *  Both formats support rectangular mazes of any size.
+ *
+ *  \attention Only available in non-firmware builds
+ */
+class MazeFile
+{
+public:
+    //! Magic bytes of the binary format
+    static constexpr std::string_view MAGIC{"MBMZ"};
+    static constexpr uint16_t VERSION{1};
+    static constexpr size_t HEADER_SIZE{16};
+    //! File extension used for the binary format
+    static constexpr std::string_view BINARY_EXTENSION{".maze"};
+
+    //! Load a Maze from the file at \p path, detecting the format by the magic bytes
+    static std::unique_ptr<Maze> Load(const std::filesystem::path &path);
+    //! Parse a Maze from \p data in either format, detecting the format by the magic bytes
+    static std::unique_ptr<Maze> Parse(std::span<const uint8_t> data);
+    //! Parse a Maze in the ASCII format
+    static std::unique_ptr<Maze> ParseAscii(std::string_view text);
+    //! Parse a Maze in the binary format
+    static std::unique_ptr<Maze> ParseBinary(std::span<const uint8_t> data);
+
+    //! Check if \p data starts with the binary format magic bytes
+    static bool IsBinary(std::span<const uint8_t> data) noexcept;
+    //! Get the \p maze in the binary format
+    static std::vector<uint8_t> ToBinary(Maze &maze);
+    //! Get the \p maze in the ASCII format
+    static std::string ToAscii(Maze &maze);
+    //! Save the \p maze to \p path, in the binary format if the extension is BINARY_EXTENSION
+    static void Save(Maze &maze, const std::filesystem::path &path);
+};
+
+} // namespace Core
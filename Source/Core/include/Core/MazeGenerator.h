@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "Maze.h"
+
+namespace Core
+{
+
+/*! \brief Procedural generator of mazes from a seed
+ *
+ *  Every maze starts out with every wall present, which are then carved away into a perfect maze
+ * where every tile is reachable by exactly one path. Afterwards a fraction of the remaining walls
+ * can be removed to add loops. The same seed and Options give the same maze on every platform.
+ *
+ *  The start tile is always the bottom left tile and the goal is the center tile, or the 2x2
+ * tiles in the center for even sizes. With Options::contest the mazes follow the contest rules,
+ * where the start tile is only open upwards and the goal area has no walls inside and a single
+ * entrance.
+ *
+ *  Generation is linear in the amount of tiles and uses no recursion, so mazes of 256x256 and
+ * above are fine.
+ *
+ *  \attention Only available in non-firmware builds
+ */
+class MazeGenerator
+{
+public:
+    //! Algorithm used to carve the perfect maze
+    enum class Type : uint8_t
+    {
+        //! Depth-first search carving long winding corridors
+        Backtracker,
+        //! Randomized Prim growing the maze from a frontier, giving many short dead ends
+        Prim,
+        //! Randomized Kruskal joining random walls between unconnected regions
+        Kruskal,
+    };
+
+    struct Options
+    {
+        Type type{Type::Backtracker};
+        //! Fraction of the remaining inner walls to remove after carving, 0 is a perfect maze
+        float loops{0.0f};
+        //! Follow the contest rules for the start tile and goal area
+        bool contest{false};
+    };
+
+    MazeGenerator(uint64_t seed) : rng{seed} {}
+
+    //! \brief Generate a maze of width x height
+    //!
+    //! Contest mazes must be at least 3x3 so the goal area can be surrounded
+    std::unique_ptr<Maze> Generate(int width, int height, const Options &options);
+    //! Generate a perfect maze of width x height with the recursive backtracker
+    inline std::unique_ptr<Maze> Generate(int width, int height)
+    {
+        return Generate(width, height, Options{});
+    }
+
+    //! Get the string name of a Type
+    static std::string_view GetTypeString(Type type);
+    //! Get the Type from the string name, as given by GetTypeString
+    static std::optional<Type> GetType(std::string_view name);
+
+private:
+    enum class Cell : uint8_t
+    {
+        Unvisited,
+        //! Next to the carved maze, only used by Prim
+        Frontier,
+        Visited,
+        //! Part of the contest start tile or goal area, not carved by the algorithms
+        Reserved,
+    };
+
+    std::mt19937_64 rng;
+    int width{0};
+    int height{0};
+    std::vector<Cell> cells;
+
+    //! Get a random number in [0, n)
+    uint32_t Next(uint32_t n);
+    //! Get the index of the adjacent cell in \p direction, or -1 if outside of the maze
+    int Adjacent(int cell, int direction) const noexcept;
+    //! Remove the wall between \p cell and the adjacent cell in \p direction
+    void Carve(Maze &maze, int cell, int direction);
+
+    void Backtracker(Maze &maze);
+    void Prim(Maze &maze);
+    void Kruskal(Maze &maze);
+    //! Remove \p fraction of the inner walls not touching a reserved cell
+    void AddLoops(Maze &maze, float fraction);
+};
+
+} // namespace Core
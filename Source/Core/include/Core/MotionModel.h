@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+
+#include "Inline.h"
+
+namespace Core
+{
+
+/*! \brief Simple model of the time the Mouse takes to do movements in the Maze
+ *
+ *  Straight runs start and stop at rest, accelerating and braking at the same constant rate with a
+ * trapezoidal speed profile capped by the top speed. Turns are done in place, so a path with fewer
+ * and longer straights is faster than a shorter path with more turns.
+ */
+struct MotionModel
+{
+    //! Length of a tile in meters
+    float tile_length{0.18f};
+    //! Top speed in meters per second
+    float max_speed{0.5f};
+    //! Acceleration and braking in meters per second squared
+    float acceleration{1.0f};
+    //! Time in seconds to turn 90 degrees in place
+    float turn_time{0.3f};
+    //! Time in seconds to turn 180 degrees in place
+    float reverse_time{0.5f};
+
+    //! Get the time in seconds to drive \p tiles straight, starting and stopping at rest
+    inline float StraightTime(int tiles) const noexcept
+    {
+        float distance{tiles * tile_length};
+        // Distance spent accelerating to and braking from the top speed
+        float ramp_distance{(max_speed * max_speed) / acceleration};
+        if (distance < ramp_distance)
+            return 2.0f * std::sqrt(distance / acceleration);
+        return (distance / max_speed) + (max_speed / acceleration);
+    }
+
+    //! Get the time in seconds to turn \p turns 90 degree turns in place, either way
+    inline INLINE float TurnTime(int turns) const noexcept
+    {
+        switch (turns & 3)
+        {
+        case 1:
+        case 3:
+            return turn_time;
+        case 2:
+            return reverse_time;
+        default:
+            return 0.0f;
+        }
+    }
+};
+
+} // namespace Core
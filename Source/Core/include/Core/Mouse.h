@@ -30,7 +30,7 @@ public:
     //! \brief Set the Algorithm the Mouse will use
     //!
     //! \returns Returns true if the algorithm was set
-    bool SetAlgorithm(const std::string value);
+    bool SetAlgorithm(std::string_view value);
     //! \brief Set the Algorithm to the one at \p index in AlgorithmRegistry
     //!
     //! \returns Returns true if the algorithm was set
@@ -62,7 +62,7 @@ public:
     inline void SetMaze(Maze *new_maze) noexcept { maze.reset(new_maze); }
 
 protected:
-    std::unique_ptr<Algorithm> algorithm{nullptr};
+    AlgorithmRegistry::Pointer algorithm{nullptr};
     std::unique_ptr<Maze> maze{nullptr};
     float x{0.0};
     float y{0.0};
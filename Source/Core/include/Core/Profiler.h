@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+
+#include "Inline.h"
+
+#if defined(FIRMWARE) && defined(PROFILER)
+#include <nrf.h>
+#endif
+
+namespace Core
+{
+
+/*! \brief Cycle profiler for the hot paths of the Firmware
+ *
+ *  Scoped probes read the DWT cycle counter of the Cortex-M4 on entry and exit, and accumulate the
+ * count, min, max and a log2 histogram of the cycles spent per Probe in static memory. Bucket `i`
+ * counts the calls taking `[2^(i-1), 2^i)` cycles, the last bucket includes everything longer.
+ *
+ *  The probes are placed with the PROFILE macro, which is only compiled in for firmware builds
+ * configured with `-DPROFILER=ON`, otherwise it expands to nothing. The statistics are read over
+ * BLE by the Simulator through Firmware::BLE::MouseService.
+ *
+ * \attention Probes are only recorded from the main loop, the statistics are not synchronised
+ */
+class Profiler
+{
+public:
+    //! The profiled functions
+    enum class Probe : uint8_t
+    {
+        MouseRun = 0,
+        StepAlgorithm,
+        Flood,
+        SetMotors,
+        ServiceUpdate,
+        Count
+    };
+
+    static constexpr size_t PROBE_COUNT{static_cast<size_t>(Probe::Count)};
+    static constexpr size_t BUCKETS{24};
+    //! Frequency of the cycle counter on the nRF52833
+    static constexpr uint32_t CYCLES_PER_US{64};
+
+    //! Statistics of a single Probe
+    struct Stats
+    {
+        uint32_t count;
+        uint32_t min;
+        uint32_t max;
+        //! Histogram of log2 cycles, saturating at the largest count
+        std::array<uint16_t, BUCKETS> buckets;
+    };
+
+    //! Enable the cycle counter, needs to be called before any probe is recorded
+    static void Init();
+    //! Clear the statistics of every Probe
+    static void Clear();
+    //! Add a call of \p probe taking \p cycles
+    static void Record(Probe probe, uint32_t cycles);
+
+    //! Get the statistics of every Probe, indexed by Probe
+    static inline const std::array<Stats, PROBE_COUNT> &GetStats() noexcept { return stats; }
+    //! Get the name of \p probe
+    static std::string_view GetName(Probe probe);
+    //! Get the histogram bucket for \p cycles
+    static constexpr size_t Bucket(uint32_t cycles) noexcept
+    {
+        size_t bucket{static_cast<size_t>(std::bit_width(cycles))};
+        return bucket < BUCKETS ? bucket : BUCKETS - 1;
+    }
+
+    //! Read the cycle counter, wraps around every ~67 s
+    static inline INLINE uint32_t Cycles() noexcept
+    {
+#if defined(FIRMWARE) && defined(PROFILER)
+        return DWT->CYCCNT;
+#else
+        return 0;
+#endif
+    }
+
+    //! Records the cycles from construction to destruction to a Probe
+    class Scope
+    {
+    public:
+        inline INLINE Scope(Probe probe) noexcept : probe{probe}, start{Cycles()} {}
+        inline INLINE ~Scope() { Record(probe, Cycles() - start); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Probe probe;
+        uint32_t start;
+    };
+
+private:
+    static std::array<Stats, PROBE_COUNT> stats;
+};
+
+} // namespace Core
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+//! Profile the rest of the enclosing scope as Core::Profiler::Probe::probe
+#if defined(FIRMWARE) && defined(PROFILER)
+#define PROFILE(probe)                                                                             \
+    Core::Profiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)                                 \
+    {                                                                                              \
+        Core::Profiler::Probe::probe                                                               \
+    }
+#else
+#define PROFILE(probe)
+#endif
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Maze.h"
+#include "MazeBitboard.h"
+#include "Simulation.h"
+
+namespace Core
+{
+
+/*! \brief Compact append-only recording of every step of a Simulation run
+ *
+ *  Every step is stored as a variable-length record of the heading, the direction chosen by the
+ * Algorithm, the StepResult and the walls learned by the Mouse during the step, which is usually
+ * 2-8 bytes. The position is implied by the moves of the previous records.
+ *
+ *  Every `keyframe_interval` steps, or whenever the position does not follow from the previous
+ * record, a keyframe is stored with the position and every wall known before the step. Any step
+ * is reached by a binary search for the closest keyframe before it, followed by decoding at most
+ * `keyframe_interval` records, so long runs can be scrubbed and compared without re-running them.
+ *
+ *  The binary format is a 24 byte header followed by the keyframes and the records, with every
+ * value being little-endian:
+ *
+ *  | Offset | Size   | Value                                                                |
+ *  |--------|--------|----------------------------------------------------------------------|
+ *  | 0      | 4      | Magic `MBTR`                                                         |
+ *  | 4      | 2      | Version, currently 1                                                 |
+ *  | 6      | 2      | Width                                                                |
+ *  | 8      | 2      | Height                                                               |
+ *  | 10     | 2      | Keyframe interval                                                    |
+ *  | 12     | 4      | Amount of steps                                                      |
+ *  | 16     | 4      | Amount of keyframes                                                  |
+ *  | 20     | 4      | Size of the records in bytes                                         |
+ *  | 24     | k*n    | Keyframes of step (4), record offset (4), x (2), y (2), heading (1), |
+ *  |        |        | padding (3) and the MazeBitboard::Words() of the known walls         |
+ *  | ...    | ...    | Records                                                              |
+ *
+ *  \attention Only available in non-firmware builds
+ */
+class RunTrace
+{
+public:
+    //! Magic bytes of the binary format
+    static constexpr std::string_view MAGIC{"MBTR"};
+    static constexpr uint16_t VERSION{1};
+    static constexpr size_t HEADER_SIZE{24};
+    //! File extension used for traces
+    static constexpr std::string_view EXTENSION{".trace"};
+
+    using Wall = Simulation::LearnedWall;
+
+    //! A single recorded Simulation::Step
+    struct Record
+    {
+        //! Index of the step since the start of the run
+        uint32_t step{0};
+        //! Position before the step
+        int x{0};
+        int y{0};
+        //! Heading before the step
+        Direction heading{Direction::Up};
+        //! Direction chosen by the Algorithm, nullopt if it did not return any
+        std::optional<Direction> direction{std::nullopt};
+        Simulation::StepResult result{Simulation::StepResult::Invalid};
+        //! Walls learned by the Mouse during the step
+        std::vector<Wall> walls{};
+    };
+
+    /*! \brief Sequential reader of the records from a step
+     *
+     *  Keeps track of the walls known before the current step, so it can replay the Maze of the
+     * Mouse at any step
+     */
+    class Cursor
+    {
+    public:
+        //! \brief Decode the record of the current step and move to the next step
+        //!
+        //! \returns Returns false if there are no more records, throws if the record is truncated
+        bool Next(Record &record);
+
+        //! Get the current step
+        inline uint32_t Step() const noexcept { return step; }
+        //! Get the walls known before the current step
+        inline const MazeBitboard &Walls() const noexcept { return walls; }
+
+    private:
+        friend class RunTrace;
+        Cursor(const RunTrace *trace, size_t keyframe);
+
+        const RunTrace *trace;
+        uint32_t step;
+        size_t offset;
+        int x;
+        int y;
+        //! Index of the next keyframe, which may reset the position
+        size_t next_keyframe;
+        MazeBitboard walls;
+    };
+
+    //! \brief Start a trace of the Mouse \p known Maze
+    //!
+    //! The walls, start and goal tiles of \p known are the state before the first step
+    RunTrace(Maze &known, uint16_t keyframe_interval = 256);
+
+    //! Append the next step from \p x, \p y facing \p heading, learning \p walls
+    void Append(int x, int y, Direction heading, std::optional<Direction> direction,
+                Simulation::StepResult result, std::span<const Wall> walls);
+
+    //! Get the amount of steps recorded
+    inline uint32_t Size() const noexcept { return steps; }
+    inline int GetWidth() const noexcept { return width; }
+    inline int GetHeight() const noexcept { return height; }
+    //! Get the size of the records in bytes, excluding the keyframes
+    inline size_t GetRecordsSize() const noexcept { return records.size(); }
+
+    //! Get a Cursor at \p step, which can be at most Size()
+    Cursor At(uint32_t step) const;
+    //! Get the record of \p step
+    Record Get(uint32_t step) const;
+    //! Write the walls, start and goal tiles known before \p step into the \p maze of same size
+    void Restore(uint32_t step, Maze &maze) const;
+
+    //! \brief Find the first step where the position, heading, direction or result differs
+    //!
+    //! \returns Returns nullopt if both traces are the same, or the step where the shorter trace
+    //! ended if one trace is a prefix of the other
+    static std::optional<uint32_t> FirstDifference(const RunTrace &a, const RunTrace &b);
+
+    //! Get the trace in the binary format
+    std::vector<uint8_t> ToBinary() const;
+    //! Parse a trace in the binary format, every keyframe and record is validated
+    static RunTrace FromBinary(std::span<const uint8_t> data);
+    //! Save the trace to \p path
+    void Save(const std::filesystem::path &path) const;
+    //! Load a trace from \p path
+    static RunTrace Load(const std::filesystem::path &path);
+
+private:
+    struct Keyframe
+    {
+        uint32_t step;
+        //! Offset in records of the record of the step
+        uint32_t offset;
+        uint16_t x;
+        uint16_t y;
+        Direction heading;
+    };
+
+    RunTrace(int width, int height, uint16_t keyframe_interval);
+
+    int width;
+    int height;
+    uint16_t keyframe_interval;
+    uint32_t steps{0};
+    std::vector<uint8_t> records;
+    std::vector<Keyframe> keyframes;
+    //! MazeBitboard::Words() of every keyframe after each other
+    std::vector<MazeBitboard::Word> keyframe_words;
+
+    //! Walls known after the last record, used for the keyframes while recording
+    MazeBitboard known;
+    //! Position after the last record
+    int next_x{0};
+    int next_y{0};
+};
+
+} // namespace Core
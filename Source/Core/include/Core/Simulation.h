@@ -0,0 +1,156 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Maze.h"
+#include "MazeBitboard.h"
+#include "MotionModel.h"
+#include "Mouse.h"
+
+namespace Core
+{
+
+class RunTrace;
+
+/*! \brief Headless simulation of a Mouse running an Algorithm inside of a known Maze
+ *
+ *  The Simulation owns the true Maze loaded from a file and a Mouse that only knows what it has
+ * sensed. Every Step traces the walls visible to the Mouse, runs the Algorithm and moves the Mouse
+ * one tile. Time is virtual, so steps can be run as fast as the host allows without SDL or ImGui.
+ *
+ *  The virtual time is an estimate of the time the real Mouse would take using the MotionModel.
+ * Consecutive steps in the same direction are driven as a single straight run with acceleration,
+ * while changing direction stops the Mouse and turns it in place.
+ *
+ *  Every Step can be recorded to a RunTrace set with SetTrace, to replay or compare the run later.
+ *
+ *  \attention Only available in non-firmware builds
+ */
+class Simulation
+{
+public:
+    //! Result of a single Simulation::Step
+    enum class StepResult
+    {
+        //! The Mouse moved to an adjacent tile
+        Moved,
+        //! The Mouse is at the goal (or start when returning)
+        Finished,
+        //! The Algorithm did not return any direction
+        NoDirection,
+        //! The Algorithm tried moving through a wall
+        Crashed,
+        //! There is no Mouse or Algorithm to step
+        Invalid,
+    };
+
+    //! Summary of a complete run done with Simulation::Run
+    struct RunResult
+    {
+        //! The result of the last step done
+        StepResult result{StepResult::Invalid};
+        //! Amount of tiles moved
+        uint64_t steps{0};
+        //! Amount of unique tiles visited including the start tile
+        uint64_t explored{0};
+        //! Virtual time in seconds spent on the run
+        double time{0.0};
+    };
+
+    //! A wall learned by the Mouse during a Step
+    struct LearnedWall
+    {
+        int x;
+        int y;
+        Direction side;
+    };
+
+    //! Create a Simulation of the \p maze, the walls of \p maze are never exposed to the Mouse
+    Simulation(std::unique_ptr<Maze> maze);
+
+    //! Load a Maze from the ASCII or binary maze file at \p path, see MazeFile
+    static std::unique_ptr<Maze> OpenMaze(std::string path);
+
+    //! Reset the Mouse and the Simulation state, using the Algorithm at \p algorithm index
+    //!
+    //! \returns Returns true if the algorithm was set
+    bool Reset(size_t algorithm);
+    //! Reset the Mouse and the Simulation state, using the Algorithm named \p algorithm
+    //!
+    //! \returns Returns true if the algorithm was set
+    bool Reset(const std::string &algorithm);
+    //! Step the Algorithm and move the Mouse a single tile
+    StepResult Step();
+    //! Step until the Mouse is finished, fails or \p max_steps has been reached
+    RunResult Run(uint64_t max_steps);
+    //! \brief Estimate the virtual time of the fastest speed run from the start to the goal
+    //!
+    //! The route is planned with SpeedRun over the tiles visited so far, so every wall on it is
+    //! known. Returns nullopt if no route through the visited tiles reaches the goal
+    std::optional<double> SpeedRunTime();
+    //! \brief Record every Step into \p trace, or stop recording if nullptr
+    //!
+    //! The \p trace is not owned and should be created from the Mouse Maze after Reset. Stepping
+    //! again after the run ended records the end only once
+    inline void SetTrace(RunTrace *trace) noexcept { this->trace = trace; }
+    //! Get the string name of a StepResult, with Moved being an unfinished run
+    static std::string_view GetStepResultString(StepResult result);
+
+    //! Get the true Maze of the Simulation
+    inline Maze *GetMaze() noexcept { return maze.get(); }
+    //! Get the simulated Mouse
+    inline Mouse *GetMouse() noexcept { return mouse.get(); }
+    //! Get the amount of tiles moved since reset
+    inline uint64_t GetSteps() noexcept { return steps; }
+    //! Get the amount of unique tiles visited since reset
+    inline uint64_t GetExplored() noexcept { return explored; }
+    //! Get the virtual time in seconds since reset
+    inline double GetTime() noexcept { return time; }
+    //! Get the walls learned by the Mouse during the last Step
+    inline const std::vector<LearnedWall> &GetLearnedWalls() noexcept { return learned; }
+
+    //! Model of the time movements take, used for the virtual time
+    MotionModel model{};
+
+private:
+    std::unique_ptr<Maze> maze;
+    //! Walls of the true Maze, used for tracing and crash checks
+    MazeBitboard walls;
+    std::unique_ptr<Mouse> mouse;
+    int width;
+    int height;
+    uint64_t steps{0};
+    uint64_t explored{0};
+    double time{0.0};
+    //! Tiles driven in the current straight run, 0 when standing still
+    int straight{0};
+    std::vector<bool> visited;
+    std::vector<LearnedWall> learned;
+    RunTrace *trace{nullptr};
+    //! Result of the last Step, a run which ended keeps returning it without moving
+    StepResult last_result{StepResult::Moved};
+
+    //! Reset the state of Simulation after Mouse has been reset
+    void ResetState();
+    //! Mark a tile as visited, counting it as explored if not visited before
+    void Visit(int x, int y);
+    //! \brief Get the virtual time of moving a tile in \p direction when facing \p facing
+    //!
+    //! \p straight is the tiles driven in the current straight run, and is updated by the move
+    double MoveTime(Direction facing, Direction direction, int &straight) const;
+    //! Step without recording to the trace, setting the \p direction returned by the Algorithm
+    StepResult Advance(std::optional<Direction> &direction);
+    //! \brief Trace using the Simulation in the Direction, return the hit MazeTile from the Mouse
+    //! Maze
+    //!
+    //! \p x and \p y are updated to the position of the hit MazeTile
+    MazeTile &TraceTile(Direction direction, int &x, int &y);
+    //! Trace the 3 direction the MicroMouse can see and add it to the Mouse Maze
+    void TraceWalls(Direction front_direction, int x, int y);
+};
+
+} // namespace Core
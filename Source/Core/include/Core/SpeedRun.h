@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "Maze.h"
+#include "MotionModel.h"
+
+namespace Core
+{
+
+namespace Algorithms
+{
+class WeightedFloodFill;
+}
+
+/*! \brief Compiler of the fastest known route in a Maze into a list of motion primitives
+ *
+ *  The route is found with Algorithms::WeightedFloodFill over the known walls, so the Maze should
+ * be explored along the route. It is then split into the tile edges crossed and the turns between
+ * them, where every run of straights becomes a single Straight, every zig-zag of alternating turns
+ * becomes a diagonal and every other turn becomes a smooth 90 degree turn inside of a tile.
+ *
+ *  The motions start at the center of the start tile and end at the center of the target tile,
+ * which lets the Mouse execute the whole route without stepping an Algorithm at every tile. A
+ * route turning back on itself drives to the center of the tile and turns around with a Rotate.
+ */
+class SpeedRun
+{
+public:
+    //! A single motion primitive
+    struct Motion
+    {
+        enum class Type : uint8_t
+        {
+            //! Turn in place by `turn` 90 degree turns in the center of a tile, done first to face
+            //! the route and to turn around where the route reverses
+            Rotate,
+            //! Drive straight along the maze for `length` half tiles
+            Straight,
+            //! Smooth 90 degree turn to the `turn` side, from the entry to the exit edge of a tile
+            Turn,
+            //! Smooth 45 degree turn to the `turn` side, from an orthogonal to a diagonal heading
+            DiagonalEnter,
+            //! Drive diagonally across `length` tiles, each from the middle of an edge to the middle
+            //! of the next which is half a tile diagonal
+            Diagonal,
+            //! Smooth 45 degree turn to the `turn` side, from a diagonal to an orthogonal heading
+            DiagonalExit,
+        };
+
+        Type type;
+        //! Turn side, -1 is left and 1 is right, 2 for turning around which is only used by Rotate
+        int8_t turn{0};
+        //! Length in half tiles for Straight and in half tile diagonals for Diagonal
+        uint16_t length{0};
+
+        auto operator<=>(const Motion &) const = default;
+    };
+
+    //! \brief Plan the route from the tile at x, y facing \p heading to the goal or start
+    //!
+    //! The times to the target are flooded into \p flood, which has to be of the size of \p maze.
+    //! It is provided by the caller so it can live in static storage on the micro:bit
+    //!
+    //! \returns Returns true if a route was found, the motions are empty if already at the target
+    bool Plan(Algorithms::WeightedFloodFill &flood, Maze &maze, int x, int y, Direction heading,
+              bool to_start, const MotionModel &model = MotionModel{});
+#ifndef FIRMWARE
+    //! Plan the route using a flood of its own, see Plan
+    bool Plan(Maze &maze, int x, int y, Direction heading, bool to_start,
+              const MotionModel &model = MotionModel{});
+#endif
+    //! Compile the global directions of every tile moved from the start facing \p heading
+    void Compile(Direction heading, std::span<const Direction> directions);
+
+    //! Get the motions of the last Plan or Compile
+    inline const TileStorage<Motion> &GetMotions() const noexcept { return motions; }
+    //! Get the global directions of every tile moved in the last Plan
+    inline const TileStorage<Direction> &GetDirections() const noexcept { return directions; }
+    //! Get the string name of a Motion::Type
+    static std::string_view GetTypeString(Motion::Type type);
+
+private:
+    TileStorage<Direction> directions;
+    TileStorage<Motion> motions;
+};
+
+} // namespace Core
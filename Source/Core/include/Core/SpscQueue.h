@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "Inline.h"
+
+namespace Core
+{
+
+/*! \brief Lock-free single-producer single-consumer ring buffer stored inline
+ *
+ *  One context may push and another may pop at the same time without locks, for example an
+ * interrupt pushing and the main loop popping. The indices only grow and are wrapped when indexing,
+ * so the full capacity \p N is usable. \p N must be a power of two.
+ *
+ *  Everything but the pushing methods must only be called by the consumer.
+ */
+template <typename T, size_t N> class SpscQueue
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    //! Push \p value, returns false if the queue is full
+    inline INLINE bool Push(const T &value) noexcept
+    {
+        size_t head{this->head.load(std::memory_order_relaxed)};
+        if (head - tail.load(std::memory_order_acquire) == N)
+            return false;
+
+        items[head & (N - 1)] = value;
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Push all of \p values or nothing, returns false if there is not enough space
+    bool Push(std::span<const T> values) noexcept
+    {
+        size_t head{this->head.load(std::memory_order_relaxed)};
+        if (N - (head - tail.load(std::memory_order_acquire)) < values.size())
+            return false;
+
+        for (size_t i{0}; i < values.size(); ++i)
+            items[(head + i) & (N - 1)] = values[i];
+        this->head.store(head + values.size(), std::memory_order_release);
+        return true;
+    }
+
+    //! Pop the oldest value if any
+    inline INLINE std::optional<T> Pop() noexcept
+    {
+        size_t tail{this->tail.load(std::memory_order_relaxed)};
+        if (head.load(std::memory_order_acquire) == tail)
+            return std::nullopt;
+
+        T value{items[tail & (N - 1)]};
+        this->tail.store(tail + 1, std::memory_order_release);
+        return value;
+    }
+
+    //! Copy the oldest values into \p out without popping them, returns the count copied
+    size_t Peek(std::span<T> out) const noexcept
+    {
+        size_t tail{this->tail.load(std::memory_order_relaxed)};
+        size_t count{std::min(out.size(), head.load(std::memory_order_acquire) - tail)};
+
+        for (size_t i{0}; i < count; ++i)
+            out[i] = items[(tail + i) & (N - 1)];
+        return count;
+    }
+
+    //! Pop \p count values, which must not be more than Size
+    inline INLINE void Drop(size_t count) noexcept
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    //! Pop everything pushed so far
+    inline INLINE void Clear() noexcept
+    {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    //! Get the count of values in the queue
+    inline INLINE size_t Size() const noexcept
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+    }
+    inline INLINE bool Empty() const noexcept { return Size() == 0; }
+    static constexpr size_t Capacity() noexcept { return N; }
+
+private:
+    std::array<T, N> items{};
+    //! Index of the next value pushed, only written by the producer
+    std::atomic<size_t> head{0};
+    //! Index of the next value popped, only written by the consumer
+    std::atomic<size_t> tail{0};
+};
+
+} // namespace Core
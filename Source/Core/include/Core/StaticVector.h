@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
+#include "Inline.h"
+
+namespace Core
+{
+
+/*! \brief Fixed-capacity vector stored inline without any heap allocation
+ *
+ *  Implements the subset of the `std::vector` interface used by Core, so the same code can use
+ * either. Growing past the capacity \p N is a bug, it is only checked in non-firmware builds.
+ */
+template <typename T, size_t N> class StaticVector
+{
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    StaticVector() = default;
+    //! Create with \p count elements of \p value
+    StaticVector(size_t count, const T &value = T()) { resize(count, value); }
+
+    inline INLINE T &operator[](size_t i) noexcept { return items[i]; }
+    inline INLINE const T &operator[](size_t i) const noexcept { return items[i]; }
+
+    inline INLINE size_t size() const noexcept { return count; }
+    inline INLINE bool empty() const noexcept { return count == 0; }
+    static constexpr size_t capacity() noexcept { return N; }
+
+    inline INLINE T *data() noexcept { return items.data(); }
+    inline INLINE const T *data() const noexcept { return items.data(); }
+    inline INLINE iterator begin() noexcept { return items.data(); }
+    inline INLINE iterator end() noexcept { return items.data() + count; }
+    inline INLINE const_iterator begin() const noexcept { return items.data(); }
+    inline INLINE const_iterator end() const noexcept { return items.data() + count; }
+    inline INLINE T &front() noexcept { return items[0]; }
+    inline INLINE T &back() noexcept { return items[count - 1]; }
+
+    inline INLINE void clear() noexcept { count = 0; }
+    inline INLINE void push_back(const T &value)
+    {
+        CheckCapacity(count + 1);
+        items[count++] = value;
+    }
+    inline INLINE void pop_back() noexcept { count--; }
+    //! Resize to \p new_count elements, new elements are set to \p value
+    void resize(size_t new_count, const T &value = T())
+    {
+        CheckCapacity(new_count);
+        if (new_count > count)
+            std::fill(items.begin() + count, items.begin() + new_count, value);
+        count = new_count;
+    }
+    //! Replace the elements with the range \p first to \p last
+    template <typename It> void assign(It first, It last)
+    {
+        CheckCapacity(static_cast<size_t>(std::distance(first, last)));
+        count = std::copy(first, last, items.begin()) - items.begin();
+    }
+
+private:
+    std::array<T, N> items{};
+    size_t count{0};
+
+    inline INLINE void CheckCapacity(size_t required) const
+    {
+#ifndef FIRMWARE
+        if (required > N)
+            throw std::length_error("StaticVector capacity exceeded");
+#endif
+    }
+};
+
+} // namespace Core
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "Inline.h"
+#include "Maze.h"
+#include "MazeBitboard.h"
+
+namespace Core
+{
+
+/*! \brief Flood fill propagating the whole wavefront at once using bitwise operations
+ *
+ *  Every tile is a bit in a row-major bitset, with a mask per Direction for the tiles able to
+ * move that way. A wavefront step is shifting the frontier masked by each Direction, by 1 bit
+ * horizontally or `width` bits vertically, and removing the already visited tiles. The word
+ * operations use AVX2 when the CPU supports it, otherwise a portable scalar loop.
+ *
+ *  The resulting values are the same as Algorithms::FloodFill::Flood, with unreachable tiles being
+ * the max value.
+ *
+ *  \attention Only available in non-firmware builds
+ */
+class WavefrontFlood
+{
+public:
+    using Value = uint16_t;
+    using Word = uint64_t;
+
+    //! Create a flood for mazes of the width and height specified
+    WavefrontFlood(int width, int height);
+
+    //! Load the walls, start and goal tiles of the \p bitboard
+    void SetWalls(const MazeBitboard &bitboard);
+    //! Load the walls, start and goal tiles of the \p maze
+    inline void SetWalls(Maze &maze) { SetWalls(MazeBitboard(maze)); }
+
+    //! Flood the walls loaded by SetWalls from goal tiles, or start tiles if \p to_start
+    void Flood(bool to_start);
+    //! Load the walls of the \p maze and flood it
+    inline void Flood(Maze &maze, bool to_start)
+    {
+        SetWalls(maze);
+        Flood(to_start);
+    }
+    //! Load the walls of the \p bitboard and flood it
+    inline void Flood(const MazeBitboard &bitboard, bool to_start)
+    {
+        SetWalls(bitboard);
+        Flood(to_start);
+    }
+
+    //! Get the value of the tile at the x, y position
+    inline INLINE Value GetValue(int x, int y) const noexcept { return values[(width * y) + x]; }
+    //! Get the values of every tile, indexed as `(width * y) + x`
+    inline const std::vector<Value> &Values() const noexcept { return values; }
+    //! Get the amount of wavefront steps the last Flood took
+    inline int GetSteps() const noexcept { return steps; }
+    //! Returns true if the AVX2 implementation is used
+    static bool UsesAVX2();
+
+private:
+    int width;
+    int height;
+    //! Words in every bitset
+    int words;
+    //! Zero words before and after every bitset, so shifted loads never go out of bounds
+    int padding;
+    int steps{0};
+    std::vector<Value> values;
+
+    // Bitsets including padding, indexed by Direction
+    std::vector<Word> open[4];
+    std::vector<Word> starts;
+    std::vector<Word> goals;
+    std::vector<Word> visited;
+    std::vector<Word> frontier;
+    std::vector<Word> next;
+    std::vector<Word> moving[4];
+
+    //! Set the value of every tile set in the \p reached bitset to \p value
+    void Assign(const Word *reached, Value value);
+    //! Do a single wavefront step, returns true if any new tiles was reached
+    bool WaveStep();
+    bool WaveStepScalar();
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __attribute__((target("avx2"))) bool WaveStepAVX2();
+#elif defined(__AVX2__)
+    bool WaveStepAVX2();
+#endif
+
+    inline INLINE Word *Data(std::vector<Word> &bitset) noexcept
+    {
+        return bitset.data() + padding;
+    }
+};
+
+} // namespace Core
@@ -1,25 +1,126 @@
 #include "Core/Algorithm.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
 namespace Core
 {
 
 std::optional<std::string> Algorithm::GetText(Mouse *mouse, int x, int y) { return std::nullopt; }
 
-bool AlgorithmRegistry::Register(const std::string &name, AlgorithmConstructor constructor)
+// Slots in the name hash table, a power of two with at most half of them used
+static constexpr size_t REGISTRY_SLOTS{AlgorithmRegistry::MAX_ALGORITHMS * 2};
+static_assert((REGISTRY_SLOTS & (REGISTRY_SLOTS - 1)) == 0);
+
+//! Flat table of the registered algorithms, with a hash table of indexes by name
+struct RegistryTable
+{
+    std::array<AlgorithmRegistry::Entry, AlgorithmRegistry::MAX_ALGORITHMS> entries;
+    size_t size{0};
+    //! Algorithm index + 1 by name hash with linear probing, 0 is an empty slot
+    std::array<uint8_t, REGISTRY_SLOTS> slots{};
+};
+
+// Function local static, so it is initialized before any REGISTER_ALGORITHM uses it
+static RegistryTable &GetTable()
 {
-    auto &registry{GetRegistry()};
+    static RegistryTable table;
 
-    registry[name] = constructor;
+    return table;
+}
+
+// FNV-1a hash of the name
+static constexpr uint32_t HashName(std::string_view name)
+{
+    uint32_t hash{2166136261u};
+    for (char c : name)
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    return hash;
+}
+
+bool AlgorithmRegistry::Register(std::string_view name, AlgorithmConstructor constructor)
+{
+    auto &table{GetTable()};
+
+    // Replace if already registered
+    if (auto index{Find(name)})
+    {
+        table.entries[*index].constructor = constructor;
+        return true;
+    }
+
+    if (table.size >= MAX_ALGORITHMS)
+        return false;
+
+    // Insert sorted by name to keep the indexes independent of the static initialization order
+    auto end{table.entries.begin() + table.size};
+    auto it{std::upper_bound(table.entries.begin(), end, name,
+                             [](std::string_view name, const Entry &entry)
+                             { return name < entry.name; })};
+    std::move_backward(it, end, end + 1);
+    *it = Entry{.name = name, .constructor = constructor};
+    table.size++;
+
+    // The indexes after the inserted Algorithm moved, so rebuild the hash table
+    table.slots.fill(0);
+    for (size_t i{0}; i < table.size; ++i)
+    {
+        size_t slot{HashName(table.entries[i].name) & (REGISTRY_SLOTS - 1)};
+        while (table.slots[slot])
+            slot = (slot + 1) & (REGISTRY_SLOTS - 1);
+        table.slots[slot] = static_cast<uint8_t>(i + 1);
+    }
 
     return true;
 }
 
-//! Access the registry of Algorithm registrated
-AlgorithmRegistry::Registry &AlgorithmRegistry::GetRegistry()
+AlgorithmRegistry::Registry AlgorithmRegistry::GetRegistry() noexcept
+{
+    auto &table{GetTable()};
+
+    return Registry(table.entries.data(), table.size);
+}
+
+const AlgorithmRegistry::Entry *AlgorithmRegistry::Get(size_t index) noexcept
+{
+    auto &table{GetTable()};
+
+    return index < table.size ? &table.entries[index] : nullptr;
+}
+
+std::optional<size_t> AlgorithmRegistry::Find(std::string_view name) noexcept
+{
+    auto &table{GetTable()};
+
+    for (size_t slot{HashName(name) & (REGISTRY_SLOTS - 1)}; table.slots[slot];
+         slot = (slot + 1) & (REGISTRY_SLOTS - 1))
+    {
+        size_t index{table.slots[slot] - 1u};
+        if (table.entries[index].name == name)
+            return index;
+    }
+
+    return std::nullopt;
+}
+
+void AlgorithmRegistry::Deleter::operator()(Algorithm *algorithm) const
+{
+#ifdef FIRMWARE
+    // Constructed in the static storage
+    algorithm->~Algorithm();
+#else
+    delete algorithm;
+#endif
+}
+
+#ifdef FIRMWARE
+void *AlgorithmRegistry::GetStorage()
 {
-    static Registry registry;
+    alignas(std::max_align_t) static std::byte storage[ALGORITHM_STORAGE_SIZE];
 
-    return registry;
+    return storage;
 }
+#endif
 
 } // namespace Core
@@ -1,20 +1,29 @@
 #include "FloodFill.h"
 
+#include <algorithm>
 #include <array>
 
 #include <Core/Log.h>
+#include <Core/Profiler.h>
 
 namespace Core::Algorithms
 {
 
+// Offsets to the adjacent tile indexed by Direction
+static constexpr int DIRECTION_X[4] = {0, 1, 0, -1};
+static constexpr int DIRECTION_Y[4] = {1, 0, -1, 0};
+// Wall bits of MazeTile
+static constexpr MazeTile::ValueType WALLS{MazeTile::Up | MazeTile::Right | MazeTile::Down |
+                                           MazeTile::Left};
+
 FloodFill::FloodFill(Mouse *mouse, int width, int height)
-    : width{width}, height{height}, tiles(width * height, 0)
+    : width{width}, height{height}, tiles(width * height, 0), queue(width * height)
 {
 }
 
 std::optional<Direction> FloodFill::Step(Mouse *mouse, int x, int y, Direction direction)
 {
-    Flood(mouse->GetMaze(), mouse->ReturnStart());
+    Update(mouse->GetMaze(), mouse->ReturnStart());
 
     // Get the global back, left and right directions
     Direction left_direction{direction.TurnLeft()};
@@ -72,9 +81,12 @@ std::optional<Direction> FloodFill::Step(Mouse *mouse, int x, int y, Direction d
 
 void FloodFill::Flood(Maze *maze, bool to_start)
 {
-    std::stack<Coord> stack;
+    PROFILE(Flood);
+
+    queue.Clear();
+    visited = 0;
 
-    // Set the zeros and add to stack the goals
+    // Set the zeros and add to queue the goals
     for (int y{0}; y < height; ++y)
     {
         for (int x{0}; x < width; ++x)
@@ -83,7 +95,7 @@ void FloodFill::Flood(Maze *maze, bool to_start)
             if ((to_start && tile.Contains(MazeTile::Start)) ||
                 (!to_start && tile.Contains(MazeTile::Goal)))
             {
-                stack.push(Coord{x, y});
+                queue.Push(Coord{x, y});
                 GetValue(x, y) = 0;
             }
             else
@@ -93,23 +105,23 @@ void FloodFill::Flood(Maze *maze, bool to_start)
         }
     }
 
-    while (!stack.empty())
+    // Breadth-first, so the first value given to a tile is the lowest and it is only queued once
+    while (!queue.Empty())
     {
-        Coord coord{stack.top()};
-        stack.pop();
+        Coord coord{queue.Pop()};
+        visited++;
 
-        Value &value{GetValue(coord.x, coord.y)};
-        Value next_value = value + 1;
+        Value next_value = GetValue(coord.x, coord.y) + 1;
 
         // Preprocessor macro for "flooding" a direction
 #define FLOOD_DIRECTION(DIR, X, Y)                                                                 \
     {                                                                                              \
         int x{coord.x + X};                                                                        \
         int y{coord.y + Y};                                                                        \
-        if (maze->WithinBounds(x, y) && GetValue(x, y) > next_value &&                             \
+        if (maze->WithinBounds(x, y) && GetValue(x, y) == std::numeric_limits<Value>::max() &&     \
             !maze->HasWall(coord.x, coord.y, Direction::DIR))                                      \
         {                                                                                          \
-            stack.push(Coord{x, y});                                                               \
+            queue.Push(Coord{x, y});                                                               \
             GetValue(x, y) = next_value;                                                           \
         }                                                                                          \
     }
@@ -120,6 +132,191 @@ void FloodFill::Flood(Maze *maze, bool to_start)
         FLOOD_DIRECTION(Up, 0, 1)
         FLOOD_DIRECTION(Down, 0, -1)
     }
+
+    // Remember the walls flooded with for the next Update
+    auto &data{maze->Data()};
+    known.resize(data.size());
+    for (size_t i{0}; i < data.size(); ++i)
+        known[i] = data[i].Value();
+
+    flooded = true;
+    flooded_to_start = to_start;
+}
+
+void FloodFill::Update(Maze *maze, bool to_start)
+{
+    if (!flooded || to_start != flooded_to_start)
+        return Flood(maze, to_start);
+
+    raised.clear();
+    lowered.clear();
+
+    // Find the walls changed since last time
+    auto &data{maze->Data()};
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+        {
+            size_t i{static_cast<size_t>((width * y) + x)};
+            MazeTile::ValueType changed{
+                static_cast<MazeTile::ValueType>(data[i].Value() ^ known[i])};
+            if (!changed)
+                continue;
+
+            // Start or goal changed, just flood it all again
+            if (changed & ~WALLS)
+                return Flood(maze, to_start);
+
+            for (int d{0}; d < 4; ++d)
+            {
+                Direction direction{static_cast<Direction::ValueEnum>(d)};
+                if (!(changed & direction.TileSide().Value()))
+                    continue;
+
+                // Walls on the edge of the maze does not affect any path
+                int next_x{x + DIRECTION_X[d]};
+                int next_y{y + DIRECTION_Y[d]};
+                if (!maze->WithinBounds(next_x, next_y))
+                    continue;
+
+                // The adjacent tile might still hold the wall
+                bool wall{maze->HasWall(x, y, direction)};
+                if (wall == HadWall(x, y, direction))
+                    continue;
+
+                auto &changes{wall ? raised : lowered};
+                if (!Add(changes, Coord{x, y}) || !Add(changes, Coord{next_x, next_y}))
+                    return Flood(maze, to_start);
+            }
+        }
+    }
+
+    // Nothing changed
+    if (raised.empty() && lowered.empty())
+    {
+        visited = 0;
+        return;
+    }
+
+    for (size_t i{0}; i < data.size(); ++i)
+        known[i] = data[i].Value();
+
+    if (!Raise(maze))
+        return Flood(maze, to_start);
+    Lower(maze);
+}
+
+bool FloodFill::HadWall(int x, int y, Direction direction)
+{
+    int d{static_cast<int>(direction.Value())};
+    if (known[(width * y) + x] & direction.TileSide().Value())
+        return true;
+
+    int next_x{x + DIRECTION_X[d]};
+    int next_y{y + DIRECTION_Y[d]};
+    return next_x >= 0 && next_x < width && next_y >= 0 && next_y < height &&
+           (known[(width * next_y) + next_x] & direction.TurnRight(2).TileSide().Value());
+}
+
+bool FloodFill::Raise(Maze *maze)
+{
+    invalid.clear();
+
+    // Tiles on both sides of added walls might have lost the path they got the value from
+    while (!raised.empty())
+    {
+        Coord coord{raised.back()};
+        raised.pop_back();
+
+        Value value{GetValue(coord.x, coord.y)};
+        // Targets and unreachable tiles can not be invalidated
+        if (value == 0 || value == std::numeric_limits<Value>::max())
+            continue;
+
+        // Check if still supported by an adjacent tile with a lower value
+        bool supported{false};
+        for (int d{0}; d < 4 && !supported; ++d)
+        {
+            int x{coord.x + DIRECTION_X[d]};
+            int y{coord.y + DIRECTION_Y[d]};
+            supported = maze->WithinBounds(x, y) && GetValue(x, y) == value - 1 &&
+                        !maze->HasWall(coord.x, coord.y, static_cast<Direction::ValueEnum>(d));
+        }
+        if (supported)
+            continue;
+
+        // Invalidate and check the tiles that might have gotten their value from this tile
+        for (int d{0}; d < 4; ++d)
+        {
+            int x{coord.x + DIRECTION_X[d]};
+            int y{coord.y + DIRECTION_Y[d]};
+            if (maze->WithinBounds(x, y) && GetValue(x, y) == value + 1 &&
+                !maze->HasWall(coord.x, coord.y, static_cast<Direction::ValueEnum>(d)) &&
+                !Add(raised, Coord{x, y}))
+                return false;
+        }
+
+        GetValue(coord.x, coord.y) = std::numeric_limits<Value>::max();
+        if (!Add(invalid, coord))
+            return false;
+    }
+
+    // The valid tiles bordering the invalidated tiles are seeds for re-flooding
+    for (auto &coord : invalid)
+    {
+        for (int d{0}; d < 4; ++d)
+        {
+            int x{coord.x + DIRECTION_X[d]};
+            int y{coord.y + DIRECTION_Y[d]};
+            if (maze->WithinBounds(x, y) && GetValue(x, y) != std::numeric_limits<Value>::max() &&
+                !maze->HasWall(coord.x, coord.y, static_cast<Direction::ValueEnum>(d)) &&
+                !Add(lowered, Coord{x, y}))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void FloodFill::Lower(Maze *maze)
+{
+    // Drop unreachable seeds and sort the rest by value, so merging them with the queue will visit
+    // the tiles in increasing value order like a flood from the targets would
+    auto unreachable{[this](const Coord &coord)
+                     { return GetValue(coord.x, coord.y) == std::numeric_limits<Value>::max(); }};
+    lowered.resize(std::remove_if(lowered.begin(), lowered.end(), unreachable) - lowered.begin());
+    std::sort(lowered.begin(), lowered.end(), [this](const Coord &a, const Coord &b)
+              { return GetValue(a.x, a.y) < GetValue(b.x, b.y); });
+
+    queue.Clear();
+    visited = 0;
+    size_t seed{0};
+    while (seed < lowered.size() || !queue.Empty())
+    {
+        // Take the lowest value of next seed and queue
+        Coord coord;
+        bool take_seed{queue.Empty() ||
+                       (seed < lowered.size() && GetValue(lowered[seed].x, lowered[seed].y) <
+                                                     GetValue(queue.Front().x, queue.Front().y))};
+        if (take_seed)
+            coord = lowered[seed++];
+        else
+            coord = queue.Pop();
+        visited++;
+
+        Value next_value = GetValue(coord.x, coord.y) + 1;
+        for (int d{0}; d < 4; ++d)
+        {
+            int x{coord.x + DIRECTION_X[d]};
+            int y{coord.y + DIRECTION_Y[d]};
+            if (maze->WithinBounds(x, y) && GetValue(x, y) > next_value &&
+                !maze->HasWall(coord.x, coord.y, static_cast<Direction::ValueEnum>(d)))
+            {
+                GetValue(x, y) = next_value;
+                queue.Push(Coord{x, y});
+            }
+        }
+    }
 }
 
 std::optional<std::string> FloodFill::GetText(Mouse *mouse, int x, int y)
@@ -18,7 +18,7 @@ class WallFollower2 : public Algorithm
 {
 public:
     WallFollower2(Mouse *mouse, int width, int height)
-        : tiles{std::vector<Visits>(width * height)}, width{width}, height{height}
+        : tiles(width * height), width{width}, height{height}
     {
     }
 
@@ -89,7 +89,7 @@ public:
     }
 
 private:
-    std::vector<Visits> tiles;
+    TileStorage<Visits> tiles;
     int width;
     int height;
 
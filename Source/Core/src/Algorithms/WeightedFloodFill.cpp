@@ -0,0 +1,238 @@
+#include "WeightedFloodFill.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace Core::Algorithms
+{
+
+// Offsets to the adjacent tile indexed by Direction
+static constexpr int DIRECTION_X[4] = {0, 1, 0, -1};
+static constexpr int DIRECTION_Y[4] = {1, 0, -1, 0};
+
+WeightedFloodFill::WeightedFloodFill(Mouse *mouse, int width, int height)
+    : width{width}, height{height}, values(width * height * 4, 0),
+      heap_index(width * height * 4, -1)
+{
+    SetModel(MotionModel{});
+}
+
+void WeightedFloodFill::SetModel(const MotionModel &model)
+{
+    this->model = model;
+
+    // No straight is longer than the longest side
+    straights.resize(std::max(width, height) + 1);
+    for (size_t i{0}; i < straights.size(); ++i)
+        straights[i] = model.StraightTime(static_cast<int>(i));
+
+    flooded = false;
+}
+
+std::optional<Direction> WeightedFloodFill::Step(Mouse *mouse, int x, int y, Direction direction)
+{
+    Maze *maze{mouse->GetMaze()};
+    Update(maze, mouse->ReturnStart());
+
+    // The four directions ordered with front, right, left, back
+    std::array<Direction, 4> direction_order{direction, direction.TurnRight(),
+                                             direction.TurnLeft(), direction.TurnRight(2)};
+
+    // Go the direction with the fastest route, preferring the first in order
+    auto min_value{std::numeric_limits<Value>::infinity()};
+    std::optional<Direction> go_direction{std::nullopt};
+
+    for (auto &try_direction : direction_order)
+    {
+        auto direction_value{GetLeaveValue(maze, x, y, direction, try_direction)};
+        if (min_value > direction_value)
+        {
+            min_value = direction_value;
+            go_direction = try_direction;
+        }
+    }
+
+    return go_direction;
+}
+
+WeightedFloodFill::Value WeightedFloodFill::GetLeaveValue(Maze *maze, int x, int y,
+                                                          Direction facing, Direction direction)
+{
+    int d{static_cast<int>(direction.Value())};
+    int turns{d - static_cast<int>(facing.Value())};
+
+    // Take the fastest of every straight run possible in the direction
+    auto min_value{std::numeric_limits<Value>::infinity()};
+    for (int n{1}; !maze->HasWall(x, y, direction); ++n)
+    {
+        x += DIRECTION_X[d];
+        y += DIRECTION_Y[d];
+        if (!maze->WithinBounds(x, y))
+            break;
+
+        min_value = std::min(min_value, straights[n] + GetValue(x, y, direction));
+    }
+
+    return min_value + model.TurnTime(turns);
+}
+
+void WeightedFloodFill::Update(Maze *maze, bool to_start)
+{
+    if (!flooded || to_start != flooded_to_start)
+        return Flood(maze, to_start);
+
+    auto &data{maze->Data()};
+    for (size_t i{0}; i < data.size(); ++i)
+    {
+        if (data[i].Value() != known[i])
+            return Flood(maze, to_start);
+    }
+}
+
+void WeightedFloodFill::Flood(Maze *maze, bool to_start)
+{
+    heap.clear();
+    std::fill(values.begin(), values.end(), std::numeric_limits<Value>::infinity());
+    std::fill(heap_index.begin(), heap_index.end(), -1);
+
+    // The targets are reached regardless of heading
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+        {
+            MazeTile &tile{maze->GetTile(x, y)};
+            if ((to_start && tile.Contains(MazeTile::Start)) ||
+                (!to_start && tile.Contains(MazeTile::Goal)))
+            {
+                for (int d{0}; d < 4; ++d)
+                    Lower(State(x, y, static_cast<Direction::ValueEnum>(d)), 0);
+            }
+        }
+    }
+
+    while (!heap.empty())
+    {
+        int state{Pop()};
+        Value state_value{values[state]};
+
+        // The state is standing on a tile after driving straight in Direction d, so every tile
+        // behind it in a straight line can reach it by turning to d first
+        int d{state % 4};
+        Direction direction{static_cast<Direction::ValueEnum>(d)};
+        int x{(state / 4) % width};
+        int y{(state / 4) / width};
+
+        for (int n{1};; ++n)
+        {
+            x -= DIRECTION_X[d];
+            y -= DIRECTION_Y[d];
+            if (!maze->WithinBounds(x, y) || maze->HasWall(x, y, direction))
+                break;
+
+            Value straight_value{state_value + straights[n]};
+            for (int facing{0}; facing < 4; ++facing)
+            {
+                Value value{straight_value + model.TurnTime(d - facing)};
+                int next_state{State(x, y, static_cast<Direction::ValueEnum>(facing))};
+                if (value < values[next_state])
+                    Lower(next_state, value);
+            }
+        }
+    }
+
+    // Remember the walls flooded with for the next Update
+    auto &data{maze->Data()};
+    known.resize(data.size());
+    for (size_t i{0}; i < data.size(); ++i)
+        known[i] = data[i].Value();
+
+    flooded = true;
+    flooded_to_start = to_start;
+}
+
+void WeightedFloodFill::Lower(int state, Value value)
+{
+    values[state] = value;
+    if (heap_index[state] < 0)
+    {
+        heap_index[state] = static_cast<int>(heap.size());
+        heap.push_back(state);
+    }
+    SiftUp(heap_index[state]);
+}
+
+int WeightedFloodFill::Pop()
+{
+    int state{heap[0]};
+    heap_index[state] = -1;
+
+    int last{heap.back()};
+    heap.pop_back();
+    if (!heap.empty())
+    {
+        heap[0] = last;
+        heap_index[last] = 0;
+        SiftDown(0);
+    }
+
+    return state;
+}
+
+void WeightedFloodFill::SiftUp(int i)
+{
+    int state{heap[i]};
+    while (i > 0)
+    {
+        int parent{(i - 1) / 2};
+        if (values[heap[parent]] <= values[state])
+            break;
+
+        heap[i] = heap[parent];
+        heap_index[heap[i]] = i;
+        i = parent;
+    }
+    heap[i] = state;
+    heap_index[state] = i;
+}
+
+void WeightedFloodFill::SiftDown(int i)
+{
+    int state{heap[i]};
+    int size{static_cast<int>(heap.size())};
+    while (true)
+    {
+        int child{(2 * i) + 1};
+        if (child >= size)
+            break;
+        if (child + 1 < size && values[heap[child + 1]] < values[heap[child]])
+            child++;
+        if (values[state] <= values[heap[child]])
+            break;
+
+        heap[i] = heap[child];
+        heap_index[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = state;
+    heap_index[state] = i;
+}
+
+std::optional<std::string> WeightedFloodFill::GetText(Mouse *mouse, int x, int y)
+{
+    Value value{std::numeric_limits<Value>::infinity()};
+    for (int d{0}; d < 4; ++d)
+        value = std::min(value, GetValue(x, y, static_cast<Direction::ValueEnum>(d)));
+
+    if (value == std::numeric_limits<Value>::infinity())
+        return std::nullopt;
+    return fmt::format("{:.1f}", value);
+}
+
+// Every wall change floods again from scratch, too slow to do every step on the micro:bit, where
+// it is only used by SpeedRun to plan once
+#ifndef FIRMWARE
+REGISTER_ALGORITHM(WeightedFloodFill)
+#endif
+
+} // namespace Core::Algorithms
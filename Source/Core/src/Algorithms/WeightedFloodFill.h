@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Core/Algorithm.h"
+#include "Core/Inline.h"
+#include "Core/MotionModel.h"
+#include "Core/Mouse.h"
+
+namespace Core::Algorithms
+{
+
+/*! \brief Flood fill weighted by the time it takes to drive the path
+ *
+ *  Unlike FloodFill this finds the fastest route instead of the shortest one. The values are the
+ * time left to the target from standing still on a tile facing a Direction, found with Dijkstra
+ * from the targets. Every edge is a turn in place followed by a straight run of any length, with
+ * the times given by the MotionModel, so long straights with few turns are preferred.
+ *
+ *  The flood is only redone when the known walls or the target changed since the last step, and
+ * then it is a full Dijkstra over every tile and heading, about 70us for a 16x16 maze on a desktop
+ * and milliseconds on the micro:bit. The values of every tile and heading also take about 13 KB.
+ * So it is not registered as an Algorithm in firmware builds, where only SpeedRun uses it to plan
+ * the route once.
+ */
+class WeightedFloodFill : public Algorithm
+{
+public:
+    using Value = float;
+
+    WeightedFloodFill(Mouse *mouse, int width, int height);
+
+    std::optional<Direction> Step(Mouse *mouse, int x, int y, Direction direction);
+
+    //! Run Dijkstra from the targets over every tile and heading in the current maze
+    void Flood(Maze *maze, bool to_start);
+    //! Flood if the maze or target changed since the last Flood
+    void Update(Maze *maze, bool to_start);
+
+    //! Get the time left to the target from the tile when facing \p direction
+    inline INLINE Value GetValue(int x, int y, Direction direction) noexcept
+    {
+        return values[State(x, y, direction)];
+    }
+    //! Get the time to the target when starting from the tile and leaving towards \p direction,
+    //! including the turn from \p facing
+    Value GetLeaveValue(Maze *maze, int x, int y, Direction facing, Direction direction);
+
+    //! Set the MotionModel used for the times, takes effect on the next Flood
+    void SetModel(const MotionModel &model);
+    inline const MotionModel &GetModel() const noexcept { return model; }
+
+    //! Debug text for tiles
+    std::optional<std::string> GetText(Mouse *mouse, int x, int y);
+
+private:
+    int width;
+    int height;
+    MotionModel model;
+    //! Time to drive n tiles straight, indexed by n
+    TileStorage<Value> straights;
+    //! Time to target of every tile and heading, indexed by State
+    TileStorage<Value, 4> values;
+    //! Binary min-heap of states ordered by value, holding every state at most once
+    TileStorage<int, 4> heap;
+    //! Position of every state in the heap, -1 if not in the heap
+    TileStorage<int, 4> heap_index;
+
+    //! Tile values of the Maze at the last Flood
+    TileStorage<MazeTile::ValueType> known;
+    //! True if Flood has been ran
+    bool flooded{false};
+    //! If the last Flood was to the start
+    bool flooded_to_start{false};
+
+    inline INLINE int State(int x, int y, Direction direction) noexcept
+    {
+        return (((width * y) + x) * 4) + static_cast<int>(direction.Value());
+    }
+    //! Lower the value of the state, adding it to the heap if not already in it
+    void Lower(int state, Value value);
+    //! Remove and return the state with the lowest value in the heap
+    int Pop();
+    //! Move the heap entry at \p i up until the heap is ordered
+    void SiftUp(int i);
+    //! Move the heap entry at \p i down until the heap is ordered
+    void SiftDown(int i);
+};
+
+} // namespace Core::Algorithms
@@ -5,6 +5,11 @@ extern MicroBit uBit;
 #endif
 
 #include "Core/Log.h"
+#include "Core/SpscQueue.h"
+
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 1024
+#endif
 
 namespace Core
 {
@@ -26,32 +31,23 @@ std::string_view GetLogLevelString(const Logger::LogLevel level)
     }
 }
 
-void Logger::Log(Logger::LogLevel level, std::string_view text, bool newline)
-{
-#ifdef FIRMWARE
+Logger::LogLevel Logger::level{Logger::LogLevel::Debug};
 
-#if 0
-    // Print the log level
-    if (level != LogLevel::None)
-    {
-        auto level_str{GetLogLevelString(level)};
-        for (char c : level_str)
-        {
-            uBit.serial.putc(c);
-        }
+// Queued deferred records, pushed with interrupts masked so there is only ever a single producer
+static SpscQueue<uint8_t, LOG_BUFFER_SIZE> records;
+// Records dropped since the last record which fit
+static uint32_t dropped{0};
 
-        uBit.serial.putc(' ');
-    }
-
-    for (char c : text)
-    {
-        uBit.serial.putc(c);
-    }
+void Logger::SetLevel(LogLevel level) { Logger::level = level; }
 
-    if (newline)
-        uBit.serial.putc('\n');
-#endif
+void Logger::Log(Logger::LogLevel level, std::string_view text, bool newline)
+{
+    if (level > Logger::level)
+        return;
 
+#ifdef FIRMWARE
+    // Pre-formatted text is sent as a cut string argument
+    Defer<LogRecord::FormatId("{}")>(level, newline, text);
 #else
     if (level != LogLevel::None)
         fmt::print("{} {}", GetLogLevelString(level), text);
@@ -62,4 +58,85 @@ void Logger::Log(Logger::LogLevel level, std::string_view text, bool newline)
         fmt::print("\n");
 #endif
 }
+
+// Write the header of a record into \p out
+static void WriteHeader(uint8_t *out, Logger::LogLevel level, bool newline, uint32_t id,
+                        size_t payload_size)
+{
+#ifdef FIRMWARE
+    uint32_t time{static_cast<uint32_t>(uBit.timer.getTime())};
+#else
+    uint32_t time{0};
+#endif
+
+    out[0] = LogRecord::SYNC;
+    out[1] = static_cast<uint8_t>(payload_size);
+    out[2] = static_cast<uint8_t>(level) | (newline ? LogRecord::NEWLINE : 0);
+    std::memcpy(&out[3], &id, sizeof(id));
+    std::memcpy(&out[7], &time, sizeof(time));
+}
+
+void Logger::Push(LogLevel level, bool newline, uint32_t id, std::span<const uint8_t> payload)
+{
+    uint8_t record[LogRecord::HEADER_SIZE + LogRecord::MAX_PAYLOAD];
+    WriteHeader(record, level, newline, id, payload.size());
+    std::copy(payload.begin(), payload.end(), &record[LogRecord::HEADER_SIZE]);
+
+#ifdef FIRMWARE
+    uint32_t primask{__get_PRIMASK()};
+    __disable_irq();
+#endif
+
+    // Tell how many records were lost before the first one fitting again
+    bool fits{true};
+    if (dropped > 0)
+    {
+        uint8_t lost[LogRecord::HEADER_SIZE + 5];
+        WriteHeader(lost, LogLevel::Warn, true, LogRecord::DROPPED_ID, 5);
+        lost[LogRecord::HEADER_SIZE] = static_cast<uint8_t>(LogRecord::ArgType::UInt32);
+        std::memcpy(&lost[LogRecord::HEADER_SIZE + 1], &dropped, sizeof(dropped));
+
+        fits = records.Push(std::span<const uint8_t>{lost, sizeof(lost)});
+        if (fits)
+            dropped = 0;
+    }
+
+    if (!fits ||
+        !records.Push(std::span<const uint8_t>{record, LogRecord::HEADER_SIZE + payload.size()}))
+        dropped++;
+
+#ifdef FIRMWARE
+    __set_PRIMASK(primask);
+#endif
+}
+
+size_t Logger::Drain(std::span<uint8_t> out)
+{
+    size_t count{records.Peek(out)};
+    records.Drop(count);
+    return count;
+}
+
+void Logger::Flush()
+{
+#ifdef FIRMWARE
+    uint8_t buffer[64];
+    while (true)
+    {
+        size_t count{records.Peek(buffer)};
+        if (count == 0)
+            return;
+
+        // Only pop what the serial accepted
+        int sent{uBit.serial.send(buffer, count, ASYNC)};
+        if (sent <= 0)
+            return;
+
+        records.Drop(sent);
+        if (static_cast<size_t>(sent) < count)
+            return;
+    }
+#endif
+}
+
 }; // namespace Core
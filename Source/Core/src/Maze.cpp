@@ -47,22 +47,27 @@ std::string_view Direction::ToString()
 }
 
 /* Maze */
-Maze::Maze(int width, int height)
-    : tiles{std::vector<MazeTile>(width * height)}, width{width}, height{height}
+#ifdef FIRMWARE
+Maze::Maze(int width, int height) : tiles(this->width * this->height)
 {
+    if (width != this->width || height != this->height)
+        LOG_ERROR("Invalid maze size: {}x{}, expected: {}x{}", width, height, this->width,
+                  this->height);
 }
+#else
+Maze::Maze(int width, int height) : width{width}, height{height}, tiles(width * height) {}
+#endif
 
-Maze::Maze(int width, int height, std::span<MazeTile::ValueType> data)
-    : tiles{std::vector<MazeTile>(width * height)}, width{width}, height{height}
+Maze::Maze(int width, int height, std::span<MazeTile::ValueType> data) : Maze(width, height)
 {
-    if (data.size() != (width * height))
+    if (data.size() != tiles.size())
     {
 #ifdef FIRMWARE
-        LOG_ERROR("Invalid maze data size: {}, expected: {}", data.size(), width * height);
+        LOG_ERROR("Invalid maze data size: {}, expected: {}", data.size(), tiles.size());
         return;
 #else
         throw std::runtime_error(
-            fmt::format("Invalid maze data size: {}, expected: {}", data.size(), width * height));
+            fmt::format("Invalid maze data size: {}, expected: {}", data.size(), tiles.size()));
 #endif
     }
     else
@@ -0,0 +1,289 @@
+#include "Core/MazeArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Core/MazeFile.h"
+
+namespace Core
+{
+
+// Little-endian helpers for the archive format
+static uint64_t ReadLE(const uint8_t *data, int bytes)
+{
+    uint64_t value{0};
+    for (int i{0}; i < bytes; ++i)
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+static void WriteLE(std::vector<uint8_t> &data, uint64_t value, int bytes)
+{
+    for (int i{0}; i < bytes; ++i)
+        data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+// Mirror the maze horizontally if \p mirror and then rotate it clockwise by quarter turns
+static std::unique_ptr<Maze> Transform(Maze &maze, int rotations, bool mirror)
+{
+    int width{maze.GetWidth()};
+    int height{maze.GetHeight()};
+    bool swap{(rotations & 1) != 0};
+    auto result{std::make_unique<Maze>(swap ? height : width, swap ? width : height)};
+
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+        {
+            // Every clockwise quarter turn moves x, y to y, width - 1 - x
+            int tx{mirror ? width - x - 1 : x};
+            int ty{y};
+            int w{width};
+            for (int r{0}; r < rotations; ++r)
+            {
+                int temp{tx};
+                tx = ty;
+                ty = w - temp - 1;
+                w = (w == width) ? height : width;
+            }
+
+            MazeTile &source{maze.GetTile(x, y)};
+            MazeTile &tile{result->GetTile(tx, ty)};
+            for (int d{0}; d < 4; ++d)
+            {
+                if (!maze.HasWall(x, y, static_cast<Direction::ValueEnum>(d)))
+                    continue;
+
+                // Mirroring swaps left and right, every rotation turns the side right
+                int side{(mirror && (d & 1)) ? d ^ 2 : d};
+                tile |= Direction(static_cast<Direction::ValueEnum>((side + rotations) & 3))
+                            .TileSide();
+            }
+            if (source.Contains(MazeTile::Start))
+                tile |= MazeTile::Start;
+            if (source.Contains(MazeTile::Goal))
+                tile |= MazeTile::Goal;
+        }
+    }
+
+    return result;
+}
+
+std::vector<uint8_t> MazeArchive::Canonical(Maze &maze)
+{
+    std::vector<uint8_t> canonical;
+    for (int mirror{0}; mirror < 2; ++mirror)
+    {
+        for (int rotations{0}; rotations < 4; ++rotations)
+        {
+            auto data{MazeFile::ToBinary(*Transform(maze, rotations, mirror))};
+            if (canonical.empty() || data < canonical)
+                canonical = std::move(data);
+        }
+    }
+
+    return canonical;
+}
+
+uint64_t MazeArchive::Hash(std::span<const uint8_t> data) noexcept
+{
+    uint64_t hash{14695981039346656037ull};
+    for (auto byte : data)
+        hash = (hash ^ byte) * 1099511628211ull;
+    return hash;
+}
+
+/* MazeArchive::Builder */
+bool MazeArchive::Builder::Add(std::string_view name, Maze &maze)
+{
+    auto canonical{Canonical(maze)};
+    uint64_t hash{Hash(canonical)};
+
+    // Compare the whole canonical form on hash collisions
+    auto [begin, end]{hashes.equal_range(hash)};
+    for (auto it{begin}; it != end; ++it)
+    {
+        if (entries[it->second].canonical == canonical)
+            return false;
+    }
+
+    hashes.emplace(hash, entries.size());
+    entries.push_back(Entry{.name = std::string(name),
+                            .data = MazeFile::ToBinary(maze),
+                            .canonical = std::move(canonical)});
+    return true;
+}
+
+std::vector<uint8_t> MazeArchive::Builder::ToBinary() const
+{
+    std::vector<uint8_t> data;
+    for (char c : MAGIC)
+        data.push_back(static_cast<uint8_t>(c));
+    WriteLE(data, VERSION, 2);
+    WriteLE(data, 0, 2);
+    WriteLE(data, entries.size(), 4);
+    WriteLE(data, 0, 4);
+
+    // Keep every maze 8 byte aligned so the bitboard words can be read in place
+    auto align{[](size_t offset) { return (offset + 7) & ~size_t(7); }};
+
+    size_t offset{HEADER_SIZE + (entries.size() * ENTRY_SIZE)};
+    for (auto &entry : entries)
+    {
+        offset = align(offset);
+        WriteLE(data, offset, 8);
+        WriteLE(data, entry.data.size(), 4);
+        WriteLE(data, entry.name.size(), 4);
+        offset += entry.data.size() + entry.name.size();
+    }
+
+    for (auto &entry : entries)
+    {
+        data.resize(align(data.size()), 0);
+        data.insert(data.end(), entry.data.begin(), entry.data.end());
+        data.insert(data.end(), entry.name.begin(), entry.name.end());
+    }
+
+    return data;
+}
+
+void MazeArchive::Builder::Save(const std::filesystem::path &path) const
+{
+    std::ofstream output(path, std::ios::out | std::ios::binary);
+    if (!output)
+        throw std::runtime_error(fmt::format("Error opening file at: {}", path.string()));
+
+    auto data{ToBinary()};
+    output.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+/* MazeArchive */
+MazeArchive::MazeArchive(const std::filesystem::path &path)
+{
+#ifdef _WIN32
+    file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER file_size;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size))
+    {
+        file = nullptr;
+        throw std::runtime_error(fmt::format("Error opening file at: {}", path.string()));
+    }
+    size = static_cast<size_t>(file_size.QuadPart);
+
+    if (size >= HEADER_SIZE)
+    {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+            data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int fd{open(path.c_str(), O_RDONLY)};
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        throw std::runtime_error(fmt::format("Error opening file at: {}", path.string()));
+    }
+    size = static_cast<size_t>(st.st_size);
+
+    if (size >= HEADER_SIZE)
+    {
+        void *mapped{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+        if (mapped != MAP_FAILED)
+            data = static_cast<const uint8_t *>(mapped);
+    }
+    // The mapping stays valid after closing the file
+    close(fd);
+#endif
+
+    // The destructor is not ran when throwing from the constructor
+    auto fail{[this](std::string message)
+              {
+                  Close();
+                  throw std::runtime_error(message);
+              }};
+
+    if (size < HEADER_SIZE)
+        fail(fmt::format("Invalid maze archive header in: {}", path.string()));
+    if (!data)
+        fail(fmt::format("Error mapping file at: {}", path.string()));
+    if (std::memcmp(data, MAGIC.data(), MAGIC.size()) != 0)
+        fail(fmt::format("Invalid maze archive header in: {}", path.string()));
+
+    uint16_t version{static_cast<uint16_t>(ReadLE(data + 4, 2))};
+    if (version != VERSION)
+        fail(fmt::format("Unsupported maze archive version: {}", version));
+
+    count = static_cast<size_t>(ReadLE(data + 8, 4));
+    if (size < HEADER_SIZE + (count * ENTRY_SIZE))
+        fail(fmt::format("Maze archive is truncated: {}", path.string()));
+}
+
+MazeArchive::~MazeArchive() { Close(); }
+
+void MazeArchive::Close() noexcept
+{
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file)
+        CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (data)
+        munmap(const_cast<uint8_t *>(data), size);
+#endif
+    data = nullptr;
+}
+
+MazeArchive::Entry MazeArchive::GetEntry(size_t i) const
+{
+    if (i >= count)
+        throw std::out_of_range(fmt::format("Maze {} out of range {} mazes", i, count));
+
+    const uint8_t *entry{data + HEADER_SIZE + (i * ENTRY_SIZE)};
+    Entry result{.offset = ReadLE(entry, 8),
+                 .size = static_cast<uint32_t>(ReadLE(entry + 8, 4)),
+                 .name_size = static_cast<uint32_t>(ReadLE(entry + 12, 4))};
+
+    if (result.offset > size || size - result.offset < uint64_t(result.size) + result.name_size)
+        throw std::runtime_error(fmt::format("Maze {} is outside of the archive", i));
+
+    return result;
+}
+
+std::string_view MazeArchive::GetName(size_t i) const
+{
+    auto entry{GetEntry(i)};
+    return std::string_view(reinterpret_cast<const char *>(data + entry.offset + entry.size),
+                            entry.name_size);
+}
+
+std::span<const uint8_t> MazeArchive::GetData(size_t i) const
+{
+    auto entry{GetEntry(i)};
+    return std::span<const uint8_t>(data + entry.offset, entry.size);
+}
+
+std::unique_ptr<Maze> MazeArchive::Load(size_t i) const
+{
+    return MazeFile::ParseBinary(GetData(i));
+}
+
+} // namespace Core
@@ -0,0 +1,130 @@
+#include "Core/MazeBitboard.h"
+
+#include <algorithm>
+
+#include "Core/Log.h"
+
+namespace Core
+{
+
+MazeBitboard::MazeBitboard(int width, int height) : width{width}, height{height}
+{
+    // Horizontal walls first, then vertical walls
+    int horizontal_bits{width * (height + 1)};
+    int vertical_bits{(width + 1) * height};
+
+    base[Direction::Up] = 0;
+    base[Direction::Down] = 0;
+    base[Direction::Right] = horizontal_bits;
+    base[Direction::Left] = horizontal_bits;
+    stride[Direction::Up] = width;
+    stride[Direction::Down] = width;
+    stride[Direction::Right] = width + 1;
+    stride[Direction::Left] = width + 1;
+
+    start_base = horizontal_bits + vertical_bits;
+    goal_base = start_base + (width * height);
+
+    words.resize(GetWordCount(width, height));
+}
+
+MazeBitboard::MazeBitboard(Maze &maze) : MazeBitboard(maze.GetWidth(), maze.GetHeight())
+{
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+        {
+            MazeTile &tile{maze.GetTile(x, y)};
+
+            // Adjacent tiles share the wall, so setting either side sets it
+            if (tile.Contains(MazeTile::Up))
+                SetWall(x, y, Direction::Up);
+            if (tile.Contains(MazeTile::Right))
+                SetWall(x, y, Direction::Right);
+            if (tile.Contains(MazeTile::Down))
+                SetWall(x, y, Direction::Down);
+            if (tile.Contains(MazeTile::Left))
+                SetWall(x, y, Direction::Left);
+
+            if (tile.Contains(MazeTile::Start))
+                SetStart(x, y);
+            if (tile.Contains(MazeTile::Goal))
+                SetGoal(x, y);
+        }
+    }
+}
+
+MazeBitboard::MazeBitboard(int width, int height, std::span<const Word> words)
+    : MazeBitboard(width, height)
+{
+    if (words.size() != this->words.size())
+    {
+#ifdef FIRMWARE
+        LOG_ERROR("Invalid bitboard size: {}, expected: {}", words.size(), this->words.size());
+        return;
+#else
+        throw std::runtime_error(fmt::format("Invalid bitboard size: {}, expected: {}",
+                                             words.size(), this->words.size()));
+#endif
+    }
+
+    std::copy(words.begin(), words.end(), this->words.begin());
+}
+
+uint64_t MazeBitboard::GetWordCount(int width, int height) noexcept
+{
+    // Wall planes, then the start and goal masks, counted wide so any 16-bit size fits
+    uint64_t w{static_cast<uint64_t>(width)};
+    uint64_t h{static_cast<uint64_t>(height)};
+    uint64_t bits{(w * (h + 1)) + ((w + 1) * h) + (2 * w * h)};
+    return (bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+MazeTile MazeBitboard::GetTile(int x, int y) const noexcept
+{
+    MazeTile::ValueType value{static_cast<MazeTile::ValueType>(
+        (HasWall(x, y, Direction::Up) ? MazeTile::Up : 0) |
+        (HasWall(x, y, Direction::Right) ? MazeTile::Right : 0) |
+        (HasWall(x, y, Direction::Down) ? MazeTile::Down : 0) |
+        (HasWall(x, y, Direction::Left) ? MazeTile::Left : 0) |
+        (IsStart(x, y) ? MazeTile::Start : 0) | (IsGoal(x, y) ? MazeTile::Goal : 0))};
+
+    return MazeTile(value);
+}
+
+void MazeBitboard::CopyTo(Maze &maze) const
+{
+    for (int y{0}; y < height; ++y)
+    {
+        // Read up to a word of tiles at a time, the bits of every side of a row are contiguous
+        for (int x{0}; x < width; x += WORD_BITS)
+        {
+            int count{std::min(width - x, WORD_BITS)};
+            Word up{GetBits(WallIndex(x, y, Direction::Up), count)};
+            Word right{GetBits(WallIndex(x, y, Direction::Right), count)};
+            Word down{GetBits(WallIndex(x, y, Direction::Down), count)};
+            Word left{GetBits(WallIndex(x, y, Direction::Left), count)};
+            Word start{GetBits(StartIndex(x, y), count)};
+            Word goal{GetBits(GoalIndex(x, y), count)};
+
+            for (int i{0}; i < count; ++i)
+            {
+                maze.GetTile(x + i, y) = MazeTile(static_cast<MazeTile::ValueType>(
+                    (((up >> i) & 1) * MazeTile::Up) | (((right >> i) & 1) * MazeTile::Right) |
+                    (((down >> i) & 1) * MazeTile::Down) | (((left >> i) & 1) * MazeTile::Left) |
+                    (((start >> i) & 1) * MazeTile::Start) | (((goal >> i) & 1) * MazeTile::Goal)));
+            }
+        }
+    }
+}
+
+void MazeBitboard::ResetWalls() noexcept
+{
+    // Clear whole words of walls, then the bits of the last word shared with the start mask
+    int full_words{start_base / WORD_BITS};
+    std::fill(words.begin(), words.begin() + full_words, Word(0));
+    if (start_base % WORD_BITS)
+        words[full_words] &= ~((Word(1) << (start_base % WORD_BITS)) - 1);
+}
+
+} // namespace Core
@@ -0,0 +1,244 @@
+#include "Core/MazeFile.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include "Core/MazeBitboard.h"
+
+namespace Core
+{
+
+// Little-endian helpers for the binary format
+static uint64_t ReadLE(const uint8_t *data, int bytes)
+{
+    uint64_t value{0};
+    for (int i{0}; i < bytes; ++i)
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+static void WriteLE(std::vector<uint8_t> &data, uint64_t value, int bytes)
+{
+    for (int i{0}; i < bytes; ++i)
+        data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+std::unique_ptr<Maze> MazeFile::Load(const std::filesystem::path &path)
+{
+    // Read the whole file at once
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    if (!input)
+        throw std::runtime_error(fmt::format("Error opening file at: {}", path.string()));
+
+    std::vector<uint8_t> data(std::filesystem::file_size(path));
+    if (!input.read(reinterpret_cast<char *>(data.data()), data.size()))
+        throw std::runtime_error(fmt::format("Error reading file at: {}", path.string()));
+
+    return Parse(data);
+}
+
+std::unique_ptr<Maze> MazeFile::Parse(std::span<const uint8_t> data)
+{
+    if (IsBinary(data))
+        return ParseBinary(data);
+
+    return ParseAscii(std::string_view(reinterpret_cast<const char *>(data.data()), data.size()));
+}
+
+bool MazeFile::IsBinary(std::span<const uint8_t> data) noexcept
+{
+    return data.size() >= MAGIC.size() &&
+           std::memcmp(data.data(), MAGIC.data(), MAGIC.size()) == 0;
+}
+
+std::unique_ptr<Maze> MazeFile::ParseAscii(std::string_view text)
+{
+    // Find the non-empty lines without copying them
+    std::vector<std::string_view> lines;
+    size_t start{0};
+    while (start < text.size())
+    {
+        size_t end{text.find('\n', start)};
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        std::string_view line{text.substr(start, end - start)};
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (!line.empty())
+            lines.push_back(line);
+
+        start = end + 1;
+    }
+
+    // Find the size of the maze map
+    if (lines.empty())
+        throw std::runtime_error("Empty map file!");
+
+    int width{(static_cast<int>(lines[0].length()) - 1) / 4};
+    int height{(static_cast<int>(lines.size()) - 1) / 2};
+    if (width < 1 || height < 1)
+        throw std::runtime_error(fmt::format("Invalid map size! Got {}x{}", width, height));
+
+    // Lines might be missing trailing spaces
+    auto character{[&lines](int row, int column)
+                   {
+                       std::string_view line{lines[row]};
+                       return static_cast<size_t>(column) < line.size() ? line[column] : ' ';
+                   }};
+
+    auto maze{std::make_unique<Maze>(width, height)};
+
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+        {
+            // 0, 0 is at bottom left
+            MazeTile &tile{maze->GetTile(x, height - y - 1)};
+
+            // Get the different wall directions
+            if (character(y * 2, (x * 4) + 2) != ' ')
+                tile |= MazeTile::Up;
+            if (character((y * 2) + 2, (x * 4) + 2) != ' ')
+                tile |= MazeTile::Down;
+            if (character((y * 2) + 1, x * 4) != ' ')
+                tile |= MazeTile::Left;
+            if (character((y * 2) + 1, (x * 4) + 4) != ' ')
+                tile |= MazeTile::Right;
+
+            // Find the center character of the tile
+            switch (character((y * 2) + 1, (x * 4) + 2))
+            {
+            case 'G':
+                tile |= MazeTile::Goal;
+                break;
+            case 'S':
+                tile |= MazeTile::Start;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    return maze;
+}
+
+std::unique_ptr<Maze> MazeFile::ParseBinary(std::span<const uint8_t> data)
+{
+    if (data.size() < HEADER_SIZE || !IsBinary(data))
+        throw std::runtime_error("Invalid binary maze header!");
+
+    uint16_t version{static_cast<uint16_t>(ReadLE(data.data() + 4, 2))};
+    int width{static_cast<int>(ReadLE(data.data() + 6, 2))};
+    int height{static_cast<int>(ReadLE(data.data() + 8, 2))};
+    size_t count{static_cast<size_t>(ReadLE(data.data() + 12, 4))};
+
+    if (version != VERSION)
+        throw std::runtime_error(fmt::format("Unsupported binary maze version: {}", version));
+    if (width < 1 || height < 1)
+        throw std::runtime_error(fmt::format("Invalid map size! Got {}x{}", width, height));
+    // Checked before anything of the size in the header is allocated
+    if (count != MazeBitboard::GetWordCount(width, height))
+        throw std::runtime_error(fmt::format("Invalid bitboard size: {}, expected: {}", count,
+                                             MazeBitboard::GetWordCount(width, height)));
+    if (data.size() < HEADER_SIZE + (count * sizeof(MazeBitboard::Word)))
+        throw std::runtime_error("Binary maze file is truncated!");
+
+    // The words are stored in native order on little-endian hosts
+    std::vector<MazeBitboard::Word> words(count);
+    const uint8_t *payload{data.data() + HEADER_SIZE};
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        std::memcpy(words.data(), payload, count * sizeof(MazeBitboard::Word));
+    }
+    else
+    {
+        for (size_t i{0}; i < count; ++i)
+            words[i] = ReadLE(payload + (i * sizeof(MazeBitboard::Word)), 8);
+    }
+
+    auto maze{std::make_unique<Maze>(width, height)};
+    MazeBitboard(width, height, words).CopyTo(*maze);
+
+    return maze;
+}
+
+std::vector<uint8_t> MazeFile::ToBinary(Maze &maze)
+{
+    MazeBitboard bitboard(maze);
+    auto &words{bitboard.Words()};
+
+    std::vector<uint8_t> data;
+    data.reserve(HEADER_SIZE + (words.size() * sizeof(MazeBitboard::Word)));
+    for (char c : MAGIC)
+        data.push_back(static_cast<uint8_t>(c));
+    WriteLE(data, VERSION, 2);
+    WriteLE(data, maze.GetWidth(), 2);
+    WriteLE(data, maze.GetHeight(), 2);
+    WriteLE(data, 0, 2);
+    WriteLE(data, words.size(), 4);
+    for (auto word : words)
+        WriteLE(data, word, 8);
+
+    return data;
+}
+
+std::string MazeFile::ToAscii(Maze &maze)
+{
+    int width{maze.GetWidth()};
+    int height{maze.GetHeight()};
+
+    std::string text;
+    text.reserve(static_cast<size_t>((width * 4) + 2) * ((height * 2) + 1));
+
+    // Row of the horizontal walls to the side of a row of tiles
+    auto add_walls{[&maze, &text, width](int y, Direction side)
+                   {
+                       text += 'o';
+                       for (int x{0}; x < width; ++x)
+                           text += maze.HasWall(x, y, side) ? "---o" : "   o";
+                       text += '\n';
+                   }};
+
+    // Rows from the top, with the walls above every row of tiles
+    for (int y{height - 1}; y >= 0; --y)
+    {
+        add_walls(y, Direction::Up);
+
+        for (int x{0}; x < width; ++x)
+        {
+            MazeTile &tile{maze.GetTile(x, y)};
+            text += maze.HasWall(x, y, Direction::Left) ? "| " : "  ";
+            text += tile.Contains(MazeTile::Goal)    ? 'G'
+                    : tile.Contains(MazeTile::Start) ? 'S'
+                                                     : ' ';
+            text += ' ';
+        }
+        text += maze.HasWall(width - 1, y, Direction::Right) ? '|' : ' ';
+        text += '\n';
+    }
+    add_walls(0, Direction::Down);
+
+    return text;
+}
+
+void MazeFile::Save(Maze &maze, const std::filesystem::path &path)
+{
+    std::ofstream output(path, std::ios::out | std::ios::binary);
+    if (!output)
+        throw std::runtime_error(fmt::format("Error opening file at: {}", path.string()));
+
+    if (path.extension() == BINARY_EXTENSION)
+    {
+        auto data{ToBinary(maze)};
+        output.write(reinterpret_cast<const char *>(data.data()), data.size());
+    }
+    else
+    {
+        output << ToAscii(maze);
+    }
+}
+
+} // namespace Core
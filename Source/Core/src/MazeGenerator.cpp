@@ -0,0 +1,322 @@
+#include "Core/MazeGenerator.h"
+
+#include <numeric>
+
+namespace Core
+{
+
+// Offsets to the adjacent tile indexed by Direction
+static constexpr int DIRECTION_X[4] = {0, 1, 0, -1};
+static constexpr int DIRECTION_Y[4] = {1, 0, -1, 0};
+
+std::unique_ptr<Maze> MazeGenerator::Generate(int width, int height, const Options &options)
+{
+    if (width < 1 || height < 1)
+        throw std::runtime_error(fmt::format("Invalid map size! Got {}x{}", width, height));
+    if (options.contest && (width < 3 || height < 3))
+        throw std::runtime_error(
+            fmt::format("Contest mazes must be at least 3x3! Got {}x{}", width, height));
+
+    this->width = width;
+    this->height = height;
+    cells.assign(static_cast<size_t>(width) * height, Cell::Unvisited);
+
+    // Start with every wall present and carve them away
+    auto maze{std::make_unique<Maze>(width, height)};
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+            maze->GetTile(x, y) = MazeTile(static_cast<MazeTile::ValueType>(
+                MazeTile::Up | MazeTile::Right | MazeTile::Down | MazeTile::Left));
+    }
+
+    // The goal is the center tile on odd sides and the two center tiles on even sides
+    int goal_width{2 - (width & 1)};
+    int goal_height{2 - (height & 1)};
+    int goal_x{(width - goal_width) / 2};
+    int goal_y{(height - goal_height) / 2};
+    auto is_goal{[&](int cell)
+                 {
+                     int x{cell % width};
+                     int y{cell / width};
+                     return x >= goal_x && x < goal_x + goal_width && y >= goal_y &&
+                            y < goal_y + goal_height;
+                 }};
+
+    for (int y{goal_y}; y < goal_y + goal_height; ++y)
+    {
+        for (int x{goal_x}; x < goal_x + goal_width; ++x)
+        {
+            maze->GetTile(x, y) |= MazeTile::Goal;
+            if (options.contest)
+                cells[(width * y) + x] = Cell::Reserved;
+        }
+    }
+    maze->GetTile(0, 0) |= MazeTile::Start;
+    if (options.contest)
+        cells[0] = Cell::Reserved;
+
+    switch (options.type)
+    {
+    case Type::Prim:
+        Prim(*maze);
+        break;
+    case Type::Kruskal:
+        Kruskal(*maze);
+        break;
+    case Type::Backtracker:
+    default:
+        Backtracker(*maze);
+        break;
+    }
+
+    if (options.contest)
+    {
+        // Open up the inside of the goal area and give it a single random entrance
+        std::vector<std::pair<int, int>> entrances;
+        for (int y{goal_y}; y < goal_y + goal_height; ++y)
+        {
+            for (int x{goal_x}; x < goal_x + goal_width; ++x)
+            {
+                int cell{(width * y) + x};
+                for (int d{0}; d < 4; ++d)
+                {
+                    int adjacent{Adjacent(cell, d)};
+                    if (adjacent < 0)
+                        continue;
+
+                    if (is_goal(adjacent))
+                    {
+                        if (d == Direction::Up || d == Direction::Right)
+                            Carve(*maze, cell, d);
+                    }
+                    else
+                    {
+                        entrances.emplace_back(cell, d);
+                    }
+                }
+            }
+        }
+        auto [cell, direction]{entrances[Next(static_cast<uint32_t>(entrances.size()))]};
+        Carve(*maze, cell, direction);
+
+        // The start tile is only open upwards
+        Carve(*maze, 0, Direction::Up);
+    }
+
+    if (options.loops > 0.0f)
+        AddLoops(*maze, options.loops);
+
+    return maze;
+}
+
+uint32_t MazeGenerator::Next(uint32_t n)
+{
+    // Scale instead of using std::uniform_int_distribution, which differs between standard
+    // libraries and would give different mazes from the same seed
+    return static_cast<uint32_t>(((rng() >> 32) * n) >> 32);
+}
+
+int MazeGenerator::Adjacent(int cell, int direction) const noexcept
+{
+    int x{(cell % width) + DIRECTION_X[direction]};
+    int y{(cell / width) + DIRECTION_Y[direction]};
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return -1;
+
+    return (width * y) + x;
+}
+
+void MazeGenerator::Carve(Maze &maze, int cell, int direction)
+{
+    int adjacent{Adjacent(cell, direction)};
+    Direction side{static_cast<Direction::ValueEnum>(direction)};
+
+    maze.GetTile(cell % width, cell / width) &= ~side.TileSide();
+    maze.GetTile(adjacent % width, adjacent / width) &= ~side.TurnRight(2).TileSide();
+}
+
+void MazeGenerator::Backtracker(Maze &maze)
+{
+    int start;
+    do
+        start = static_cast<int>(Next(static_cast<uint32_t>(cells.size())));
+    while (cells[start] == Cell::Reserved);
+
+    // Walk to random unvisited neighbours, backing up on dead ends
+    std::vector<int> stack{start};
+    cells[start] = Cell::Visited;
+
+    while (!stack.empty())
+    {
+        int cell{stack.back()};
+
+        int directions[4];
+        uint32_t count{0};
+        for (int d{0}; d < 4; ++d)
+        {
+            int adjacent{Adjacent(cell, d)};
+            if (adjacent >= 0 && cells[adjacent] == Cell::Unvisited)
+                directions[count++] = d;
+        }
+
+        if (count == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        int direction{directions[Next(count)]};
+        int adjacent{Adjacent(cell, direction)};
+        Carve(maze, cell, direction);
+        cells[adjacent] = Cell::Visited;
+        stack.push_back(adjacent);
+    }
+}
+
+void MazeGenerator::Prim(Maze &maze)
+{
+    std::vector<int> frontier;
+    auto visit{[&](int cell)
+               {
+                   cells[cell] = Cell::Visited;
+                   for (int d{0}; d < 4; ++d)
+                   {
+                       int adjacent{Adjacent(cell, d)};
+                       if (adjacent >= 0 && cells[adjacent] == Cell::Unvisited)
+                       {
+                           cells[adjacent] = Cell::Frontier;
+                           frontier.push_back(adjacent);
+                       }
+                   }
+               }};
+
+    int start;
+    do
+        start = static_cast<int>(Next(static_cast<uint32_t>(cells.size())));
+    while (cells[start] == Cell::Reserved);
+    visit(start);
+
+    while (!frontier.empty())
+    {
+        // Take a random frontier cell and join it to a random visited neighbour
+        size_t i{Next(static_cast<uint32_t>(frontier.size()))};
+        int cell{frontier[i]};
+        frontier[i] = frontier.back();
+        frontier.pop_back();
+
+        int directions[4];
+        uint32_t count{0};
+        for (int d{0}; d < 4; ++d)
+        {
+            int adjacent{Adjacent(cell, d)};
+            if (adjacent >= 0 && cells[adjacent] == Cell::Visited)
+                directions[count++] = d;
+        }
+
+        Carve(maze, cell, directions[Next(count)]);
+        visit(cell);
+    }
+}
+
+void MazeGenerator::Kruskal(Maze &maze)
+{
+    // Every inner wall as cell * 2, plus 1 for the wall above instead of to the right
+    std::vector<uint32_t> walls;
+    for (int cell{0}; cell < static_cast<int>(cells.size()); ++cell)
+    {
+        if (cells[cell] == Cell::Reserved)
+            continue;
+
+        for (int d : {Direction::Right, Direction::Up})
+        {
+            int adjacent{Adjacent(cell, d)};
+            if (adjacent >= 0 && cells[adjacent] != Cell::Reserved)
+                walls.push_back((cell * 2) + (d == Direction::Up));
+        }
+    }
+
+    for (size_t i{walls.size()}; i > 1; --i)
+        std::swap(walls[i - 1], walls[Next(static_cast<uint32_t>(i))]);
+
+    // Union-find of the connected regions with path halving
+    std::vector<int> parent(cells.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find{[&parent](int cell)
+              {
+                  while (parent[cell] != cell)
+                  {
+                      parent[cell] = parent[parent[cell]];
+                      cell = parent[cell];
+                  }
+                  return cell;
+              }};
+
+    for (auto wall : walls)
+    {
+        int cell{static_cast<int>(wall / 2)};
+        int direction{(wall & 1) ? Direction::Up : Direction::Right};
+        int a{find(cell)};
+        int b{find(Adjacent(cell, direction))};
+        if (a != b)
+        {
+            parent[a] = b;
+            Carve(maze, cell, direction);
+        }
+    }
+}
+
+void MazeGenerator::AddLoops(Maze &maze, float fraction)
+{
+    std::vector<uint32_t> walls;
+    for (int cell{0}; cell < static_cast<int>(cells.size()); ++cell)
+    {
+        if (cells[cell] == Cell::Reserved)
+            continue;
+
+        for (int d : {Direction::Right, Direction::Up})
+        {
+            int adjacent{Adjacent(cell, d)};
+            if (adjacent >= 0 && cells[adjacent] != Cell::Reserved &&
+                maze.HasWall(cell % width, cell / width, static_cast<Direction::ValueEnum>(d)))
+                walls.push_back((cell * 2) + (d == Direction::Up));
+        }
+    }
+
+    // Partial shuffle to pick the walls to remove
+    size_t count{std::min(static_cast<size_t>(fraction * walls.size()), walls.size())};
+    for (size_t i{0}; i < count; ++i)
+    {
+        std::swap(walls[i], walls[i + Next(static_cast<uint32_t>(walls.size() - i))]);
+        Carve(maze, static_cast<int>(walls[i] / 2),
+              (walls[i] & 1) ? Direction::Up : Direction::Right);
+    }
+}
+
+std::string_view MazeGenerator::GetTypeString(Type type)
+{
+    switch (type)
+    {
+    case Type::Backtracker:
+        return "Backtracker";
+    case Type::Prim:
+        return "Prim";
+    case Type::Kruskal:
+        return "Kruskal";
+    default:
+        return "Invalid";
+    }
+}
+
+std::optional<MazeGenerator::Type> MazeGenerator::GetType(std::string_view name)
+{
+    for (auto type : {Type::Backtracker, Type::Prim, Type::Kruskal})
+    {
+        if (GetTypeString(type) == name)
+            return type;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace Core
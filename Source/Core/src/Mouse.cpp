@@ -23,48 +23,27 @@ Mouse::Mouse(int width, int height, bool initialize_tiles)
 
 Mouse::Mouse(std::unique_ptr<Maze> maze) : maze{std::move(maze)} {}
 
-bool Mouse::SetAlgorithm(const std::string value)
+bool Mouse::SetAlgorithm(std::string_view value)
 {
-    auto registry{AlgorithmRegistry::GetRegistry()};
+    auto index{AlgorithmRegistry::Find(value)};
+    if (!index.has_value())
+        return false;
 
-    // Calculate index in registry map
-    size_t i{0};
-    AlgorithmRegistry::Registry::iterator it;
-    for (it = registry.begin(); it != registry.end(); ++it)
-    {
-        if (it->first == value)
-            break;
-        else if (it == registry.end())
-            return false;
-        i++;
-    }
-
-    current_algorithm_index = i;
-
-    // Construct the algorithm
-    algorithm =
-        std::unique_ptr<Algorithm>(it->second(this, GetMaze()->GetWidth(), GetMaze()->GetHeight()));
-
-    return true;
+    return SetAlgorithm(index.value());
 }
 
 bool Mouse::SetAlgorithm(size_t index)
 {
-    auto registry{AlgorithmRegistry::GetRegistry()};
-
-    auto it{registry.begin()};
-    for (size_t i{0}; i < index; ++i)
-    {
-        if (it == registry.end())
-            return false;
-        it++;
-    }
+    auto entry{AlgorithmRegistry::Get(index)};
+    if (!entry)
+        return false;
 
     current_algorithm_index = index;
 
-    // Construct the algorithm
-    algorithm =
-        std::unique_ptr<Algorithm>(it->second(this, GetMaze()->GetWidth(), GetMaze()->GetHeight()));
+    // Destroy the previous algorithm first, in firmware they share the same storage
+    algorithm.reset();
+    algorithm = AlgorithmRegistry::Pointer(
+        entry->constructor(this, GetMaze()->GetWidth(), GetMaze()->GetHeight()));
 
     return true;
 }
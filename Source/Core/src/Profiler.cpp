@@ -0,0 +1,57 @@
+#include <limits>
+
+#include "Core/Profiler.h"
+
+namespace Core
+{
+
+std::array<Profiler::Stats, Profiler::PROBE_COUNT> Profiler::stats{};
+
+void Profiler::Init()
+{
+#if defined(FIRMWARE) && defined(PROFILER)
+    // Enable the trace unit and start the cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    Clear();
+}
+
+void Profiler::Clear() { stats = {}; }
+
+void Profiler::Record(Probe probe, uint32_t cycles)
+{
+    Stats &probe_stats{stats[static_cast<size_t>(probe)]};
+
+    if (probe_stats.count == 0 || cycles < probe_stats.min)
+        probe_stats.min = cycles;
+    if (cycles > probe_stats.max)
+        probe_stats.max = cycles;
+    probe_stats.count++;
+
+    uint16_t &bucket{probe_stats.buckets[Bucket(cycles)]};
+    if (bucket != std::numeric_limits<uint16_t>::max())
+        bucket++;
+}
+
+std::string_view Profiler::GetName(Probe probe)
+{
+    switch (probe)
+    {
+    case Probe::MouseRun:
+        return "Mouse2::Run";
+    case Probe::StepAlgorithm:
+        return "Mouse2::StepAlgorithm";
+    case Probe::Flood:
+        return "FloodFill::Flood";
+    case Probe::SetMotors:
+        return "DFR0548::SetMotors";
+    case Probe::ServiceUpdate:
+        return "MouseService::Update";
+    default:
+        return "";
+    }
+}
+
+} // namespace Core
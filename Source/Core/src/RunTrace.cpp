@@ -0,0 +1,369 @@
+#include "Core/RunTrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Core
+{
+
+// Offsets to the adjacent tile indexed by Direction
+static constexpr int DIRECTION_X[4] = {0, 1, 0, -1};
+static constexpr int DIRECTION_Y[4] = {1, 0, -1, 0};
+
+// Little-endian helpers for the binary format
+static uint64_t ReadLE(const uint8_t *data, int bytes)
+{
+    uint64_t value{0};
+    for (int i{0}; i < bytes; ++i)
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+static void WriteLE(std::vector<uint8_t> &data, uint64_t value, int bytes)
+{
+    for (int i{0}; i < bytes; ++i)
+        data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+// LEB128 variable-length integers, 7 bits per byte
+static void WriteVarint(std::vector<uint8_t> &data, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+static uint32_t ReadVarint(const std::vector<uint8_t> &data, size_t &offset)
+{
+    uint32_t value{0};
+    for (int shift{0}; shift < 32; shift += 7)
+    {
+        if (offset >= data.size())
+            throw std::runtime_error("Run trace record is truncated!");
+
+        uint8_t byte{data[offset++]};
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw std::runtime_error("Run trace record has an invalid varint!");
+}
+
+// The first byte of a record holds the heading in bits 0-1, the direction in bits 2-3, if there
+// is a direction in bit 4 and the StepResult in bits 5-7
+static constexpr uint8_t HAS_DIRECTION{1 << 4};
+static constexpr int RESULT_SHIFT{5};
+
+/* RunTrace::Cursor */
+RunTrace::Cursor::Cursor(const RunTrace *trace, size_t keyframe)
+    : trace{trace}, step{trace->keyframes[keyframe].step},
+      offset{trace->keyframes[keyframe].offset}, x{trace->keyframes[keyframe].x},
+      y{trace->keyframes[keyframe].y}, next_keyframe{keyframe},
+      walls(trace->width, trace->height,
+            std::span<const MazeBitboard::Word>(trace->keyframe_words)
+                .subspan(keyframe * trace->known.Words().size(), trace->known.Words().size()))
+{
+}
+
+bool RunTrace::Cursor::Next(Record &record)
+{
+    if (step >= trace->steps)
+        return false;
+
+    // Keyframes reset the position if it did not follow from the previous record
+    auto &keyframes{trace->keyframes};
+    while (next_keyframe < keyframes.size() && keyframes[next_keyframe].step <= step)
+    {
+        x = keyframes[next_keyframe].x;
+        y = keyframes[next_keyframe].y;
+        next_keyframe++;
+    }
+
+    auto &records{trace->records};
+    if (offset >= records.size())
+        throw std::runtime_error("Run trace record is truncated!");
+    uint8_t flags{records[offset++]};
+
+    record.step = step;
+    record.x = x;
+    record.y = y;
+    record.heading = static_cast<Direction::ValueEnum>(flags & 3);
+    record.direction = std::nullopt;
+    if (flags & HAS_DIRECTION)
+        record.direction = static_cast<Direction::ValueEnum>((flags >> 2) & 3);
+    record.result = static_cast<Simulation::StepResult>(flags >> RESULT_SHIFT);
+
+    record.walls.clear();
+    uint32_t count{ReadVarint(records, offset)};
+    for (uint32_t i{0}; i < count; ++i)
+    {
+        uint32_t wall{ReadVarint(records, offset)};
+        int tile{static_cast<int>(wall / 4)};
+        Wall learned{.x = tile % trace->width,
+                     .y = tile / trace->width,
+                     .side = static_cast<Direction::ValueEnum>(wall & 3)};
+        if (walls.WithinBounds(learned.x, learned.y))
+            walls.SetWall(learned.x, learned.y, learned.side);
+        record.walls.push_back(learned);
+    }
+
+    if (record.result == Simulation::StepResult::Moved && record.direction)
+    {
+        int d{static_cast<int>(record.direction->Value())};
+        x += DIRECTION_X[d];
+        y += DIRECTION_Y[d];
+    }
+
+    step++;
+    return true;
+}
+
+/* RunTrace */
+RunTrace::RunTrace(int width, int height, uint16_t keyframe_interval)
+    : width{width}, height{height}, keyframe_interval{std::max<uint16_t>(keyframe_interval, 1)},
+      known(width, height)
+{
+}
+
+RunTrace::RunTrace(Maze &known, uint16_t keyframe_interval)
+    : width{known.GetWidth()}, height{known.GetHeight()},
+      keyframe_interval{std::max<uint16_t>(keyframe_interval, 1)}, known(known)
+{
+    // The Mouse starts at 0, 0 facing up
+    keyframes.push_back(Keyframe{.step = 0, .offset = 0, .x = 0, .y = 0, .heading = Direction::Up});
+    keyframe_words = this->known.Words();
+}
+
+void RunTrace::Append(int x, int y, Direction heading, std::optional<Direction> direction,
+                      Simulation::StepResult result, std::span<const Wall> walls)
+{
+    // Keyframe regularly and when the position does not follow from the previous record
+    if (steps - keyframes.back().step >= keyframe_interval || x != next_x || y != next_y)
+    {
+        keyframes.push_back(Keyframe{.step = steps,
+                                     .offset = static_cast<uint32_t>(records.size()),
+                                     .x = static_cast<uint16_t>(x),
+                                     .y = static_cast<uint16_t>(y),
+                                     .heading = heading});
+        keyframe_words.insert(keyframe_words.end(), known.Words().begin(), known.Words().end());
+    }
+
+    uint8_t flags{static_cast<uint8_t>(heading.Value())};
+    if (direction)
+        flags |= HAS_DIRECTION | (static_cast<uint8_t>(direction->Value()) << 2);
+    flags |= static_cast<uint8_t>(result) << RESULT_SHIFT;
+    records.push_back(flags);
+
+    WriteVarint(records, static_cast<uint32_t>(walls.size()));
+    for (auto wall : walls)
+    {
+        WriteVarint(records, (((width * wall.y) + wall.x) * 4) + wall.side.Value());
+        known.SetWall(wall.x, wall.y, wall.side);
+    }
+
+    next_x = x;
+    next_y = y;
+    if (result == Simulation::StepResult::Moved && direction)
+    {
+        next_x += DIRECTION_X[direction->Value()];
+        next_y += DIRECTION_Y[direction->Value()];
+    }
+
+    steps++;
+}
+
+RunTrace::Cursor RunTrace::At(uint32_t step) const
+{
+    if (step > steps)
+        throw std::out_of_range(fmt::format("Step {} out of range {} steps", step, steps));
+
+    // Find the last keyframe at or before the step
+    auto it{std::upper_bound(keyframes.begin(), keyframes.end(), step,
+                             [](uint32_t step, const Keyframe &keyframe)
+                             { return step < keyframe.step; })};
+    Cursor cursor(this, static_cast<size_t>(std::distance(keyframes.begin(), it)) - 1);
+
+    Record record;
+    while (cursor.Step() < step)
+        cursor.Next(record);
+
+    return cursor;
+}
+
+RunTrace::Record RunTrace::Get(uint32_t step) const
+{
+    if (step >= steps)
+        throw std::out_of_range(fmt::format("Step {} out of range {} steps", step, steps));
+
+    Record record;
+    At(step).Next(record);
+    return record;
+}
+
+void RunTrace::Restore(uint32_t step, Maze &maze) const { At(step).Walls().CopyTo(maze); }
+
+std::optional<uint32_t> RunTrace::FirstDifference(const RunTrace &a, const RunTrace &b)
+{
+    auto cursor_a{a.At(0)};
+    auto cursor_b{b.At(0)};
+    Record record_a;
+    Record record_b;
+
+    while (true)
+    {
+        bool has_a{cursor_a.Next(record_a)};
+        bool has_b{cursor_b.Next(record_b)};
+        if (!has_a && !has_b)
+            return std::nullopt;
+        if (has_a != has_b || record_a.x != record_b.x || record_a.y != record_b.y ||
+            record_a.heading != record_b.heading || record_a.direction != record_b.direction ||
+            record_a.result != record_b.result)
+            return std::min(cursor_a.Step(), cursor_b.Step()) - (has_a && has_b ? 1 : 0);
+    }
+}
+
+std::vector<uint8_t> RunTrace::ToBinary() const
+{
+    size_t words{known.Words().size()};
+
+    std::vector<uint8_t> data;
+    data.reserve(HEADER_SIZE + (keyframes.size() * (16 + (words * 8))) + records.size());
+    for (char c : MAGIC)
+        data.push_back(static_cast<uint8_t>(c));
+    WriteLE(data, VERSION, 2);
+    WriteLE(data, width, 2);
+    WriteLE(data, height, 2);
+    WriteLE(data, keyframe_interval, 2);
+    WriteLE(data, steps, 4);
+    WriteLE(data, keyframes.size(), 4);
+    WriteLE(data, records.size(), 4);
+
+    for (size_t i{0}; i < keyframes.size(); ++i)
+    {
+        auto &keyframe{keyframes[i]};
+        WriteLE(data, keyframe.step, 4);
+        WriteLE(data, keyframe.offset, 4);
+        WriteLE(data, keyframe.x, 2);
+        WriteLE(data, keyframe.y, 2);
+        WriteLE(data, Direction(keyframe.heading).Value(), 1);
+        WriteLE(data, 0, 3);
+        for (size_t j{0}; j < words; ++j)
+            WriteLE(data, keyframe_words[(i * words) + j], 8);
+    }
+
+    data.insert(data.end(), records.begin(), records.end());
+    return data;
+}
+
+RunTrace RunTrace::FromBinary(std::span<const uint8_t> data)
+{
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC.data(), MAGIC.size()) != 0)
+        throw std::runtime_error("Invalid run trace header!");
+
+    uint16_t version{static_cast<uint16_t>(ReadLE(data.data() + 4, 2))};
+    if (version != VERSION)
+        throw std::runtime_error(fmt::format("Unsupported run trace version: {}", version));
+
+    int width{static_cast<int>(ReadLE(data.data() + 6, 2))};
+    int height{static_cast<int>(ReadLE(data.data() + 8, 2))};
+    if (width < 1 || height < 1)
+        throw std::runtime_error(fmt::format("Invalid map size! Got {}x{}", width, height));
+
+    RunTrace trace(width, height, static_cast<uint16_t>(ReadLE(data.data() + 10, 2)));
+    trace.steps = static_cast<uint32_t>(ReadLE(data.data() + 12, 4));
+    size_t keyframe_count{static_cast<size_t>(ReadLE(data.data() + 16, 4))};
+    size_t records_size{static_cast<size_t>(ReadLE(data.data() + 20, 4))};
+
+    // Compare against the bytes left, so huge counts can not overflow the size
+    size_t words{trace.known.Words().size()};
+    size_t keyframe_size{16 + (words * 8)};
+    size_t left{data.size() - HEADER_SIZE};
+    if (keyframe_count == 0 || keyframe_count > left / keyframe_size ||
+        records_size > left - (keyframe_count * keyframe_size))
+        throw std::runtime_error("Run trace is truncated!");
+
+    const uint8_t *keyframe{data.data() + HEADER_SIZE};
+    for (size_t i{0}; i < keyframe_count; ++i, keyframe += keyframe_size)
+    {
+        trace.keyframes.push_back(Keyframe{
+            .step = static_cast<uint32_t>(ReadLE(keyframe, 4)),
+            .offset = static_cast<uint32_t>(ReadLE(keyframe + 4, 4)),
+            .x = static_cast<uint16_t>(ReadLE(keyframe + 8, 2)),
+            .y = static_cast<uint16_t>(ReadLE(keyframe + 10, 2)),
+            .heading = static_cast<Direction::ValueEnum>(keyframe[12] & 3)});
+        for (size_t j{0}; j < words; ++j)
+            trace.keyframe_words.push_back(ReadLE(keyframe + 16 + (j * 8), 8));
+    }
+    trace.records.assign(keyframe, keyframe + records_size);
+
+    // At finds the keyframe of a step by a binary search, so they have to be in order from step 0
+    for (size_t i{0}; i < keyframe_count; ++i)
+    {
+        auto &current{trace.keyframes[i]};
+        bool ordered{i == 0 ? current.step == 0 && current.offset == 0
+                            : current.step > trace.keyframes[i - 1].step &&
+                                  current.step < trace.steps};
+        if (!ordered || current.x >= width || current.y >= height)
+            throw std::runtime_error(fmt::format("Invalid run trace keyframe {}!", i));
+    }
+
+    // Decode every record, so later reads stay in bounds. The keyframes have to point at the
+    // records of their steps and the records have to fill the records exactly
+    Cursor cursor(&trace, 0);
+    Record record;
+    size_t next_keyframe{1};
+    while (cursor.step < trace.steps)
+    {
+        if (next_keyframe < keyframe_count && trace.keyframes[next_keyframe].step == cursor.step)
+        {
+            if (trace.keyframes[next_keyframe].offset != cursor.offset)
+                throw std::runtime_error(
+                    fmt::format("Invalid run trace keyframe {}!", next_keyframe));
+            next_keyframe++;
+        }
+
+        cursor.Next(record);
+        if (record.x < 0 || record.x >= width || record.y < 0 || record.y >= height ||
+            record.result > Simulation::StepResult::Invalid)
+            throw std::runtime_error(fmt::format("Invalid run trace record {}!", record.step));
+    }
+    if (cursor.offset != records_size)
+        throw std::runtime_error(fmt::format("Run trace records do not match {} steps!",
+                                             trace.steps));
+
+    // Continue from the end when appending to a loaded trace
+    trace.known = cursor.Walls();
+    trace.next_x = cursor.x;
+    trace.next_y = cursor.y;
+
+    return trace;
+}
+
+void RunTrace::Save(const std::filesystem::path &path) const
+{
+    std::ofstream output(path, std::ios::out | std::ios::binary);
+    if (!output)
+        throw std::runtime_error(fmt::format("Error opening file at: {}", path.string()));
+
+    auto data{ToBinary()};
+    output.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+RunTrace RunTrace::Load(const std::filesystem::path &path)
+{
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    if (!input)
+        throw std::runtime_error(fmt::format("Error opening file at: {}", path.string()));
+
+    std::vector<uint8_t> data(std::filesystem::file_size(path));
+    if (!input.read(reinterpret_cast<char *>(data.data()), data.size()))
+        throw std::runtime_error(fmt::format("Error reading file at: {}", path.string()));
+
+    return FromBinary(data);
+}
+
+} // namespace Core
@@ -0,0 +1,314 @@
+#include <cmath>
+
+#include "Core/Log.h"
+#include "Core/MazeFile.h"
+#include "Core/RunTrace.h"
+#include "Core/Simulation.h"
+#include "Core/SpeedRun.h"
+
+namespace Core
+{
+
+Simulation::Simulation(std::unique_ptr<Maze> maze)
+    : maze{std::move(maze)}, walls{*this->maze}, width{this->maze->GetWidth()},
+      height{this->maze->GetHeight()}
+{
+    // Create a maze for the mouse, but do not include the walls
+    auto mouse_maze = std::make_unique<Maze>(width, height);
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+        {
+            MazeTile &tile{this->maze->GetTile(x, y)};
+            MazeTile &mouse_tile{mouse_maze->GetTile(x, y)};
+            if (tile.Contains(MazeTile::Goal))
+                mouse_tile |= MazeTile::Goal;
+            if (tile.Contains(MazeTile::Start))
+                mouse_tile |= MazeTile::Start;
+        }
+    }
+
+    // Initialise the mouse
+    mouse = std::make_unique<Mouse>(std::move(mouse_maze));
+    visited.resize(width * height);
+}
+
+std::unique_ptr<Maze> Simulation::OpenMaze(std::string path) { return MazeFile::Load(path); }
+
+bool Simulation::Reset(size_t algorithm)
+{
+    mouse->Reset();
+    ResetState();
+
+    // Set the algorithm for the Mouse
+    return mouse->SetAlgorithm(algorithm);
+}
+
+bool Simulation::Reset(const std::string &algorithm)
+{
+    mouse->Reset();
+    ResetState();
+
+    // Set the algorithm for the Mouse
+    return mouse->SetAlgorithm(algorithm);
+}
+
+void Simulation::ResetState()
+{
+    steps = 0;
+    explored = 0;
+    time = 0.0;
+    straight = 0;
+    last_result = StepResult::Moved;
+    std::fill(visited.begin(), visited.end(), false);
+    Visit(0, 0);
+
+    // Set up the default walls
+    // Add the back wall if start is at 0,0
+    MazeTile &mouse_tile{mouse->GetMaze()->GetTile(0, 0)};
+    if (mouse_tile.Contains(MazeTile::Start))
+        mouse_tile |= MazeTile::Down;
+}
+
+Simulation::StepResult Simulation::Step()
+{
+    // Stop if no algorithm
+    if (!mouse->GetAlgorithm())
+        return StepResult::Invalid;
+
+    int x{(int)std::round(mouse->X())};
+    int y{(int)std::round(mouse->Y())};
+    Direction heading{mouse->GetDirection()};
+
+    learned.clear();
+    std::optional<Direction> direction;
+    StepResult result{Advance(direction)};
+
+    // Stepping an ended run again changes nothing, so only record the first end
+    bool repeated{result != StepResult::Moved && result == last_result};
+    if (trace && !repeated)
+        trace->Append(x, y, heading, direction, result, learned);
+
+    last_result = result;
+    return result;
+}
+
+Simulation::StepResult Simulation::Advance(std::optional<Direction> &move_direction)
+{
+    // Get the absolute x, y the mouse is in
+    int x{(int)std::round(mouse->X())};
+    int y{(int)std::round(mouse->Y())};
+    auto &tile{maze->GetTile(x, y)};
+
+    // For now just stop when Goal is found
+    bool is_returning{mouse->ReturnStart()};
+    if ((!is_returning && tile.Contains(MazeTile::Goal)) ||
+        (is_returning && tile.Contains(MazeTile::Start)))
+        return StepResult::Finished;
+
+    Direction front_direction{mouse->GetDirection()};
+
+    // Trace the walls if at start
+    if (tile.Contains(MazeTile::Start))
+        TraceWalls(front_direction, x, y);
+
+    // Step the algorithm
+    move_direction = mouse->GetAlgorithm()->Step(mouse.get(), x, y, front_direction);
+    if (!move_direction.has_value())
+        return StepResult::NoDirection;
+    Direction direction{move_direction.value()};
+
+    // Check if crashed
+    if (walls.HasWall(x, y, direction))
+        return StepResult::Crashed;
+
+    // Update the position
+    switch (direction.Value())
+    {
+    case Direction::Up:
+        y++;
+        break;
+    case Direction::Right:
+        x++;
+        break;
+    case Direction::Down:
+        y--;
+        break;
+    case Direction::Left:
+        x--;
+        break;
+    }
+
+    mouse->SetPosition(x, y, static_cast<Direction::ValueType>(direction.Value()) * 90.0);
+
+    steps++;
+    time += MoveTime(front_direction, direction, straight);
+    Visit(x, y);
+
+    // Do a new trace to update fake sensor results
+    TraceWalls(direction, x, y);
+
+    return StepResult::Moved;
+}
+
+Simulation::RunResult Simulation::Run(uint64_t max_steps)
+{
+    StepResult result{StepResult::Invalid};
+    for (uint64_t i{0}; i < max_steps; ++i)
+    {
+        result = Step();
+        if (result != StepResult::Moved)
+            break;
+    }
+
+    return RunResult{.result = result, .steps = steps, .explored = explored, .time = time};
+}
+
+std::optional<double> Simulation::SpeedRunTime()
+{
+    // Close every tile not visited, so the route only uses known walls
+    Maze known{*mouse->GetMaze()};
+    for (int y{0}; y < height; ++y)
+    {
+        for (int x{0}; x < width; ++x)
+        {
+            if (!visited[(width * y) + x])
+                known.GetTile(x, y) |= MazeTile(static_cast<MazeTile::ValueType>(
+                    MazeTile::Up | MazeTile::Right | MazeTile::Down | MazeTile::Left));
+        }
+    }
+
+    SpeedRun speed_run;
+    if (!speed_run.Plan(known, 0, 0, Direction::Up, false, model))
+        return std::nullopt;
+
+    int x{0};
+    int y{0};
+    int run_straight{0};
+    double run_time{0.0};
+    Direction facing{Direction::Up};
+    for (Direction direction : speed_run.GetDirections())
+    {
+        if (walls.HasWall(x, y, direction))
+            return std::nullopt;
+
+        run_time += MoveTime(facing, direction, run_straight);
+        facing = direction;
+        x += (direction == Direction::Right) - (direction == Direction::Left);
+        y += (direction == Direction::Up) - (direction == Direction::Down);
+    }
+
+    return run_time;
+}
+
+double Simulation::MoveTime(Direction facing, Direction direction, int &straight) const
+{
+    double move_time{0.0};
+
+    // Turning stops the straight run
+    int turns{static_cast<int>(direction.Value()) - static_cast<int>(facing.Value())};
+    if (turns & 3)
+    {
+        move_time += model.TurnTime(turns);
+        straight = 0;
+    }
+
+    // Extend the straight run by a tile, still braking to a stop at the end of it
+    move_time += model.StraightTime(straight + 1) - model.StraightTime(straight);
+    straight++;
+
+    return move_time;
+}
+
+std::string_view Simulation::GetStepResultString(StepResult result)
+{
+    switch (result)
+    {
+    case StepResult::Moved:
+        return "Unfinished";
+    case StepResult::Finished:
+        return "Finished";
+    case StepResult::NoDirection:
+        return "NoDirection";
+    case StepResult::Crashed:
+        return "Crashed";
+    default:
+        return "Invalid";
+    }
+}
+
+void Simulation::Visit(int x, int y)
+{
+    size_t i{static_cast<size_t>((width * y) + x)};
+    if (!visited[i])
+    {
+        visited[i] = true;
+        explored++;
+    }
+}
+
+MazeTile &Simulation::TraceTile(Direction direction, int &x, int &y)
+{
+    switch (direction.Value())
+    {
+    case Direction::Up:
+        while (height > y)
+        {
+            if (walls.HasWall(x, y, Direction::Up))
+                return mouse->GetMaze()->GetTile(x, y);
+            y++;
+        }
+        break;
+    case Direction::Right:
+        while (width > x)
+        {
+            if (walls.HasWall(x, y, Direction::Right))
+                return mouse->GetMaze()->GetTile(x, y);
+            x++;
+        }
+        break;
+    case Direction::Down:
+        while (y >= 0)
+        {
+            if (walls.HasWall(x, y, Direction::Down))
+                return mouse->GetMaze()->GetTile(x, y);
+            y--;
+        }
+        break;
+    case Direction::Left:
+        while (x >= 0)
+        {
+            if (walls.HasWall(x, y, Direction::Left))
+                return mouse->GetMaze()->GetTile(x, y);
+            x--;
+        }
+        break;
+    default:
+        throw std::runtime_error(
+            fmt::format("Invalid TraceTile direction: {}", direction.ToString()));
+    }
+
+    throw std::runtime_error(fmt::format("Maze lacks other wall, ran out at {},{}", x, y));
+}
+
+void Simulation::TraceWalls(Direction front_direction, int x, int y)
+{
+    // Find the global front, left and right directions of the Mouse
+    Direction left_direction{front_direction.TurnLeft()};
+    Direction right_direction{front_direction.TurnRight()};
+
+    // Trace the three local sensor directions and add the walls not known before
+    for (Direction direction : {front_direction, left_direction, right_direction})
+    {
+        int wall_x{x};
+        int wall_y{y};
+        MazeTile &tile{TraceTile(direction, wall_x, wall_y)};
+        if (!tile.Contains(direction.TileSide()))
+        {
+            tile |= direction.TileSide();
+            learned.push_back(LearnedWall{.x = wall_x, .y = wall_y, .side = direction});
+        }
+    }
+}
+
+} // namespace Core
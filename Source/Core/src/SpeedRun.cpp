@@ -0,0 +1,196 @@
+#include "Core/SpeedRun.h"
+
+#include <limits>
+
+#include "Algorithms/WeightedFloodFill.h"
+
+namespace Core
+{
+
+// Offsets to the adjacent tile indexed by Direction
+static constexpr int DIRECTION_X[4] = {0, 1, 0, -1};
+static constexpr int DIRECTION_Y[4] = {1, 0, -1, 0};
+
+#ifndef FIRMWARE
+bool SpeedRun::Plan(Maze &maze, int x, int y, Direction heading, bool to_start,
+                    const MotionModel &model)
+{
+    Algorithms::WeightedFloodFill flood(nullptr, maze.GetWidth(), maze.GetHeight());
+    return Plan(flood, maze, x, y, heading, to_start, model);
+}
+#endif
+
+bool SpeedRun::Plan(Algorithms::WeightedFloodFill &flood, Maze &maze, int x, int y,
+                    Direction heading, bool to_start, const MotionModel &model)
+{
+    directions.clear();
+    motions.clear();
+
+    flood.SetModel(model);
+    flood.Flood(&maze, to_start);
+
+    using Value = Algorithms::WeightedFloodFill::Value;
+    if (flood.GetValue(x, y, heading) == std::numeric_limits<Value>::infinity())
+        return false;
+
+    // Follow the fastest straight from every tile stopped at until the target is reached
+    Direction start_heading{heading};
+    MazeTile target{to_start ? MazeTile::Start : MazeTile::Goal};
+    while (!maze.GetTile(x, y).Contains(target))
+    {
+        auto min_value{std::numeric_limits<Value>::infinity()};
+        int min_direction{0};
+        int min_length{0};
+
+        for (int d{0}; d < 4; ++d)
+        {
+            Direction direction{static_cast<Direction::ValueEnum>(d)};
+            Value turn_value{model.TurnTime(d - static_cast<int>(heading.Value()))};
+
+            int test_x{x};
+            int test_y{y};
+            for (int n{1}; !maze.HasWall(test_x, test_y, direction); ++n)
+            {
+                test_x += DIRECTION_X[d];
+                test_y += DIRECTION_Y[d];
+                if (!maze.WithinBounds(test_x, test_y))
+                    break;
+
+                Value value{turn_value + model.StraightTime(n) +
+                            flood.GetValue(test_x, test_y, direction)};
+                if (min_value > value)
+                {
+                    min_value = value;
+                    min_direction = d;
+                    min_length = n;
+                }
+            }
+        }
+        if (min_value == std::numeric_limits<Value>::infinity())
+            return false;
+
+        heading = static_cast<Direction::ValueEnum>(min_direction);
+        for (int n{0}; n < min_length; ++n)
+            directions.push_back(heading);
+        x += DIRECTION_X[min_direction] * min_length;
+        y += DIRECTION_Y[min_direction] * min_length;
+    }
+
+    Compile(start_heading, directions);
+    return true;
+}
+
+void SpeedRun::Compile(Direction heading, std::span<const Direction> directions)
+{
+    motions.clear();
+    if (directions.empty())
+        return;
+
+    // Right turns from one direction to another, 3 being a left turn
+    auto turn_between{[](Direction from, Direction to)
+                      {
+                          int turns{static_cast<int>(to.Value()) - static_cast<int>(from.Value())};
+                          return turns & 3;
+                      }};
+
+    // Turn in place to face the first tile
+    int rotate{turn_between(heading, directions[0])};
+    if (rotate)
+        motions.push_back(Motion{.type = Motion::Type::Rotate,
+                                 .turn = static_cast<int8_t>(rotate == 3 ? -1 : rotate)});
+
+    // Turn between the entry edge of tile i and the next, -1 is left, 0 straight, 1 right and 2
+    // turning back
+    size_t turns{directions.size() - 1};
+    auto turn_at{[&directions, &turn_between](size_t i)
+                 {
+                     int turn{turn_between(directions[i], directions[i + 1])};
+                     return turn == 3 ? -1 : turn;
+                 }};
+
+    // Half tiles of straight not yet added, starting from the center of the start tile
+    uint16_t straight{1};
+    auto add_straight{[this, &straight]()
+                      {
+                          if (straight)
+                              motions.push_back(
+                                  Motion{.type = Motion::Type::Straight, .length = straight});
+                          straight = 0;
+                      }};
+
+    size_t i{0};
+    while (i < turns)
+    {
+        int turn{turn_at(i)};
+        if (turn == 0)
+        {
+            straight += 2;
+            i++;
+            continue;
+        }
+
+        // Drive to the center of the tile and turn around in place
+        if (turn == 2)
+        {
+            straight += 1;
+            add_straight();
+            motions.push_back(Motion{.type = Motion::Type::Rotate, .turn = 2});
+            straight = 1;
+            i++;
+            continue;
+        }
+
+        add_straight();
+
+        // Find the end of the zig-zag of alternating turns starting here
+        size_t end{i};
+        while (end + 1 < turns && turn_at(end + 1) == -turn_at(end))
+            end++;
+
+        if (end == i)
+        {
+            motions.push_back(
+                Motion{.type = Motion::Type::Turn, .turn = static_cast<int8_t>(turn)});
+        }
+        else
+        {
+            // The diagonal goes through the middle of every edge crossed inside the zig-zag
+            motions.push_back(
+                Motion{.type = Motion::Type::DiagonalEnter, .turn = static_cast<int8_t>(turn)});
+            if (end - i > 1)
+                motions.push_back(Motion{.type = Motion::Type::Diagonal,
+                                         .length = static_cast<uint16_t>(end - i - 1)});
+            motions.push_back(Motion{.type = Motion::Type::DiagonalExit,
+                                     .turn = static_cast<int8_t>(turn_at(end))});
+        }
+
+        i = end + 1;
+    }
+
+    // End at the center of the target tile
+    straight += 1;
+    add_straight();
+}
+
+std::string_view SpeedRun::GetTypeString(Motion::Type type)
+{
+    switch (type)
+    {
+    case Motion::Type::Rotate:
+        return "Rotate";
+    case Motion::Type::Straight:
+        return "Straight";
+    case Motion::Type::Turn:
+        return "Turn";
+    case Motion::Type::DiagonalEnter:
+        return "DiagonalEnter";
+    case Motion::Type::Diagonal:
+        return "Diagonal";
+    case Motion::Type::DiagonalExit:
+        return "DiagonalExit";
+    default:
+        return "Unknown";
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,250 @@
+#include "Core/WavefrontFlood.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define WAVEFRONT_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define WAVEFRONT_AVX2
+#endif
+
+namespace Core
+{
+
+static constexpr int WORD_BITS{64};
+
+WavefrontFlood::WavefrontFlood(int width, int height) : width{width}, height{height}
+{
+    // Round up to whole AVX2 registers, the extra bits are never set in the direction masks
+    words = (((width * height) + WORD_BITS - 1) / WORD_BITS + 3) & ~3;
+    // Vertical shifts read up to width / 64 + 1 words away
+    padding = (width / WORD_BITS) + 2;
+
+    size_t size{static_cast<size_t>(words + (2 * padding))};
+    for (int d{0}; d < 4; ++d)
+    {
+        open[d].resize(size);
+        moving[d].resize(size);
+    }
+    starts.resize(size);
+    goals.resize(size);
+    visited.resize(size);
+    frontier.resize(size);
+    next.resize(size);
+    values.resize(width * height);
+}
+
+bool WavefrontFlood::UsesAVX2()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static bool avx2{__builtin_cpu_supports("avx2") != 0};
+    return avx2;
+#elif defined(__AVX2__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void WavefrontFlood::SetWalls(const MazeBitboard &bitboard)
+{
+    for (int d{0}; d < 4; ++d)
+        std::fill(open[d].begin(), open[d].end(), Word(0));
+    std::fill(starts.begin(), starts.end(), Word(0));
+    std::fill(goals.begin(), goals.end(), Word(0));
+
+    // Bitsets written to, with the bit index of every row of the bitboard to read from
+    std::pair<Word *, int> rows[6];
+
+    // Copy every row in chunks of up to a word, the walls of a row side are contiguous bits
+    for (int y{0}; y < height; ++y)
+    {
+        rows[0] = {Data(open[Direction::Up]), bitboard.WallIndex(0, y, Direction::Up)};
+        rows[1] = {Data(open[Direction::Right]), bitboard.WallIndex(0, y, Direction::Right)};
+        rows[2] = {Data(open[Direction::Down]), bitboard.WallIndex(0, y, Direction::Down)};
+        rows[3] = {Data(open[Direction::Left]), bitboard.WallIndex(0, y, Direction::Left)};
+        rows[4] = {Data(starts), bitboard.StartIndex(0, y)};
+        rows[5] = {Data(goals), bitboard.GoalIndex(0, y)};
+
+        for (int x{0}; x < width; x += WORD_BITS)
+        {
+            int count{std::min(width - x, WORD_BITS)};
+            Word all{count < WORD_BITS ? (Word(1) << count) - 1 : ~Word(0)};
+
+            for (int i{0}; i < 6; ++i)
+            {
+                Word bits{bitboard.GetBits(rows[i].second + x, count)};
+                // The walls are inverted to get the open sides
+                if (i < 4)
+                    bits = ~bits & all;
+
+                // Only open towards tiles inside of the maze, so no bits are shifted outside
+                if ((i == Direction::Up && y == height - 1) || (i == Direction::Down && y == 0))
+                    bits = 0;
+                if (i == Direction::Right && x + count == width)
+                    bits &= ~(Word(1) << (count - 1));
+                if (i == Direction::Left && x == 0)
+                    bits &= ~Word(1);
+
+                // Or the bits into the row, possibly spanning two words
+                int index{(width * y) + x};
+                Word *bitset{rows[i].first};
+                bitset[index / WORD_BITS] |= bits << (index % WORD_BITS);
+                if ((index % WORD_BITS) + count > WORD_BITS)
+                    bitset[(index / WORD_BITS) + 1] |= bits >> (WORD_BITS - (index % WORD_BITS));
+            }
+        }
+    }
+}
+
+void WavefrontFlood::Flood(bool to_start)
+{
+    std::fill(values.begin(), values.end(), std::numeric_limits<Value>::max());
+    std::fill(next.begin(), next.end(), Word(0));
+
+    // Seed the targets
+    auto &targets{to_start ? starts : goals};
+    std::copy(targets.begin(), targets.end(), frontier.begin());
+    std::copy(targets.begin(), targets.end(), visited.begin());
+    Assign(Data(frontier), 0);
+
+    // Propagate the wavefront until no new tiles are reached
+    steps = 0;
+    Value value{0};
+    while (WaveStep())
+    {
+        Assign(Data(next), ++value);
+        std::swap(frontier, next);
+        steps++;
+    }
+}
+
+void WavefrontFlood::Assign(const Word *reached, Value value)
+{
+    for (int i{0}; i < words; ++i)
+    {
+        Word word{reached[i]};
+        while (word)
+        {
+            values[(i * WORD_BITS) + std::countr_zero(word)] = value;
+            word &= word - 1;
+        }
+    }
+}
+
+bool WavefrontFlood::WaveStep()
+{
+#ifdef WAVEFRONT_AVX2
+    if (UsesAVX2())
+        return WaveStepAVX2();
+#endif
+    return WaveStepScalar();
+}
+
+// Get word i of bitset a shifted left (towards higher tiles) by q words and r bits
+static inline INLINE WavefrontFlood::Word ShiftUp(const WavefrontFlood::Word *a, int i, int q,
+                                                 int r) noexcept
+{
+    return r ? (a[i - q] << r) | (a[i - q - 1] >> (WORD_BITS - r)) : a[i - q];
+}
+
+// Get word i of bitset a shifted right (towards lower tiles) by q words and r bits
+static inline INLINE WavefrontFlood::Word ShiftDown(const WavefrontFlood::Word *a, int i, int q,
+                                                   int r) noexcept
+{
+    return r ? (a[i + q] >> r) | (a[i + q + 1] << (WORD_BITS - r)) : a[i + q];
+}
+
+bool WavefrontFlood::WaveStepScalar()
+{
+    const Word *f{Data(frontier)};
+    Word *m[4];
+    for (int d{0}; d < 4; ++d)
+    {
+        const Word *o{Data(open[d])};
+        m[d] = Data(moving[d]);
+        for (int i{0}; i < words; ++i)
+            m[d][i] = f[i] & o[i];
+    }
+
+    int q{width / WORD_BITS};
+    int r{width % WORD_BITS};
+    Word *v{Data(visited)};
+    Word *n{Data(next)};
+    Word any{0};
+    for (int i{0}; i < words; ++i)
+    {
+        Word reached{ShiftUp(m[Direction::Right], i, 0, 1) |
+                     ShiftDown(m[Direction::Left], i, 0, 1) |
+                     ShiftUp(m[Direction::Up], i, q, r) | ShiftDown(m[Direction::Down], i, q, r)};
+        reached &= ~v[i];
+        v[i] |= reached;
+        n[i] = reached;
+        any |= reached;
+    }
+
+    return any != 0;
+}
+
+#ifdef WAVEFRONT_AVX2
+
+#define LOAD(ptr) _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr))
+#define STORE(ptr, value) _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr), value)
+
+WAVEFRONT_AVX2 bool WavefrontFlood::WaveStepAVX2()
+{
+    const Word *f{Data(frontier)};
+    Word *m[4];
+    for (int d{0}; d < 4; ++d)
+    {
+        const Word *o{Data(open[d])};
+        m[d] = Data(moving[d]);
+        for (int i{0}; i < words; i += 4)
+            STORE(m[d] + i, _mm256_and_si256(LOAD(f + i), LOAD(o + i)));
+    }
+
+    int q{width / WORD_BITS};
+    // Shifting 64 bits or more gives zero, so a whole word shift needs no special case
+    __m128i one{_mm_cvtsi32_si128(1)};
+    __m128i one_carry{_mm_cvtsi32_si128(WORD_BITS - 1)};
+    __m128i r{_mm_cvtsi32_si128(width % WORD_BITS)};
+    __m128i r_carry{_mm_cvtsi32_si128(WORD_BITS - (width % WORD_BITS))};
+
+    Word *v{Data(visited)};
+    Word *n{Data(next)};
+    __m256i any{_mm256_setzero_si256()};
+    for (int i{0}; i < words; i += 4)
+    {
+        const Word *right{m[Direction::Right] + i};
+        const Word *left{m[Direction::Left] + i};
+        const Word *up{m[Direction::Up] + i - q};
+        const Word *down{m[Direction::Down] + i + q};
+
+        __m256i reached{_mm256_or_si256(_mm256_sll_epi64(LOAD(right), one),
+                                        _mm256_srl_epi64(LOAD(right - 1), one_carry))};
+        reached = _mm256_or_si256(reached, _mm256_srl_epi64(LOAD(left), one));
+        reached = _mm256_or_si256(reached, _mm256_sll_epi64(LOAD(left + 1), one_carry));
+        reached = _mm256_or_si256(reached, _mm256_sll_epi64(LOAD(up), r));
+        reached = _mm256_or_si256(reached, _mm256_srl_epi64(LOAD(up - 1), r_carry));
+        reached = _mm256_or_si256(reached, _mm256_srl_epi64(LOAD(down), r));
+        reached = _mm256_or_si256(reached, _mm256_sll_epi64(LOAD(down + 1), r_carry));
+
+        __m256i visited_words{LOAD(v + i)};
+        reached = _mm256_andnot_si256(visited_words, reached);
+        STORE(v + i, _mm256_or_si256(visited_words, reached));
+        STORE(n + i, reached);
+        any = _mm256_or_si256(any, reached);
+    }
+
+    return !_mm256_testz_si256(any, any);
+}
+
+#undef LOAD
+#undef STORE
+
+#endif
+
+} // namespace Core
@@ -3,6 +3,7 @@
 
 #include <Core/Algorithm.h>
 #include <Core/Log.h>
+#include <Core/Profiler.h>
 
 #include "MouseService.h"
 
@@ -57,6 +58,11 @@ MouseService::MouseService(Mouse2 *mouse) : mouse{mouse}
                          tile_values.size() * sizeof(tile_values[0]),
                          tile_values.size() * sizeof(tile_values[0]),
                          microbit_propREAD | microbit_propREADAUTH | microbit_propNOTIFY);
+    // Profile
+    CreateCharacteristic(CHARACTERISTIC(MouseService, Profile),
+                         CHARACTERISTIC_UUID(MouseService, Profile), (uint8_t *)profile.data(),
+                         sizeof(profile), sizeof(profile),
+                         microbit_propREAD | microbit_propREADAUTH);
 }
 
 void MouseService::onDataWritten(const microbit_ble_evt_write_t *params)
@@ -80,26 +86,19 @@ void MouseService::onDataWritten(const microbit_ble_evt_write_t *params)
 
         algorithm_index = *(BLE_STRUCTURE(MouseService, AlgorithmCount) *)params->data;
 
-        auto registry{Core::AlgorithmRegistry::GetRegistry()};
-
-        auto it = registry.begin();
-        for (size_t i{0}; i < algorithm_index; ++i)
+        // Return if OOB
+        auto entry{Core::AlgorithmRegistry::Get(algorithm_index)};
+        if (!entry)
         {
-            it++;
-
-            // Return if OOB
-            if (it == registry.end())
-            {
-                algorithm_name_buffer[0] = '\0';
-                return;
-            }
+            algorithm_name_buffer[0] = '\0';
+            return;
         }
 
         // Copy algorithm name
-        std::copy_n(it->first.begin(), std::min(it->first.size(), size_t(MAX_ALGORITHM_NAME)),
-                    algorithm_name_buffer.begin());
+        size_t length{std::min(entry->name.size(), size_t(MAX_ALGORITHM_NAME))};
+        std::copy_n(entry->name.begin(), length, algorithm_name_buffer.begin());
 
-        algorithm_name_buffer[std::min(it->first.size(), size_t(MAX_ALGORITHM_NAME))] = '\0';
+        algorithm_name_buffer[length] = '\0';
     }
     else if (params->handle == valueHandle(CHARACTERISTIC(MouseService, Action)))
     {
@@ -127,6 +126,13 @@ void MouseService::onDataWritten(const microbit_ble_evt_write_t *params)
             if (!mouse->IsMoving())
                 mouse->Step();
 
+            break;
+        // Clear the profiler statistics
+        case BLE_STRUCTURE(MouseService, MouseAction)::ClearProfile:
+            LOG_INFO("[BLE] Clear profile");
+
+            Core::Profiler::Clear();
+
             break;
         default:
             break;
@@ -140,10 +146,16 @@ void MouseService::onDataRead(microbit_onDataRead_t *params)
     {
         UpdateTiles();
     }
+    else if (params->handle == valueHandle(CHARACTERISTIC(MouseService, Profile)))
+    {
+        profile = Core::Profiler::GetStats();
+    }
 }
 
 void MouseService::Update()
 {
+    PROFILE(ServiceUpdate);
+
     // Ignore if disconnected
     if (!getConnected())
         return;
@@ -177,7 +189,7 @@ void MouseService::Update()
 
 void MouseService::UpdateTiles()
 {
-    auto tiles{mouse->GetMaze()->Data()};
+    auto &tiles{mouse->GetMaze()->Data()};
 
     // Update size if needed
     if (tiles.size() != tile_values.size())
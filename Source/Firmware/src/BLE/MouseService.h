@@ -20,6 +20,7 @@ namespace Firmware::BLE
  * - Set speed factor
  * - Get tracked position
  * - Get maze data
+ * - Get the Core::Profiler statistics
  */
 class MouseService : public MicroBitBLEService
 {
@@ -51,6 +52,7 @@ private:
     BLE_STRUCTURE(MouseService, MousePosition) position;
     BLE_STRUCTURE(MouseService, AlgorithmCount) algorithm_index;
     std::array<Core::MazeTile::ValueType, 16 * 16> tile_values{};
+    BLE_STRUCTURE(MouseService, Profile) profile{};
     std::array<char, MAX_ALGORITHM_NAME + 1> algorithm_name_buffer;
     int last_iter{0};
 };
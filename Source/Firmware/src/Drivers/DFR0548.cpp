@@ -5,6 +5,7 @@
 #include "DFR0548.h"
 
 #include <Core/Log.h>
+#include <Core/Profiler.h>
 
 namespace Firmware::Drivers
 {
@@ -132,6 +133,8 @@ void DFR0548::Update()
 
 void DFR0548::SetMotors(int16_t m1_speed, int16_t m2_speed, int16_t m3_speed, int16_t m4_speed)
 {
+    PROFILE(SetMotors);
+
     set_motors.m1 = m1_speed;
     set_motors.m2 = m2_speed;
     set_motors.m3 = m3_speed;
@@ -7,8 +7,8 @@ extern MicroBit uBit;
 namespace Firmware::Drivers
 {
 
-HCSR04::HCSR04(std::vector<Sensor> sensors, uint16_t measurement_interval)
-    : sensors{sensors}, measurement_interval{measurement_interval}
+HCSR04::HCSR04(std::vector<Sensor> sensors, uint16_t timeout, uint16_t settle)
+    : sensors{sensors}, timeout{timeout}, settle{settle}
 {
     // Setup echo pin event handling
     for (auto &sensor : sensors)
@@ -17,25 +17,48 @@ HCSR04::HCSR04(std::vector<Sensor> sensors, uint16_t measurement_interval)
         uBit.messageBus.listen(sensor.echo_pin.id, DEVICE_PIN_EVT_PULSE_HI, this, &HCSR04::OnPulse,
                                MESSAGE_BUS_LISTENER_IMMEDIATE);
         last_measurements.push_back(0);
+        group_count = std::max<uint8_t>(group_count, sensor.group + 1);
     }
 
-    // Setup trigger timer
+    // Setup trigger timers and start measuring
     timer = std::make_unique<Timer>([this]() { this->Run(); });
-    timer->EveryMs(measurement_interval);
+    trigger = std::make_unique<Timer>([this]() { this->EndTrigger(); });
+    Run();
 }
 
 void HCSR04::Run()
 {
     if (sensors.empty())
         return;
-    // Get ready for the next sensor
-    idx = (idx + 1) % sensors.size();
-    // Set high (trig)
-    sensors[idx].trig_pin.setDigitalValue(true);
-    // Wait for 10us
-    system_timer_wait_us(10);
-    // Set low (trig)
-    sensors[idx].trig_pin.setDigitalValue(false);
+
+    uint32_t primask{__get_PRIMASK()};
+    __disable_irq();
+
+    // Any echo still pending from the last group is lost
+    pending = 0;
+    for (size_t i{0}; i < sensors.size(); ++i)
+    {
+        if (sensors[i].group != group)
+            continue;
+        // Set high (trig)
+        sensors[i].trig_pin.setDigitalValue(true);
+        pending |= 1u << i;
+    }
+    trigger->AfterUs(TRIGGER_US);
+    // Move on if not every echo arrives in time
+    timer->AfterMs(timeout);
+
+    // Get ready for the next group
+    group = (group + 1) % group_count;
+
+    __set_PRIMASK(primask);
+}
+
+void HCSR04::EndTrigger()
+{
+    // Set low (trig), lowering the pins of the other groups does nothing
+    for (auto &sensor : sensors)
+        sensor.trig_pin.setDigitalValue(false);
 }
 
 void HCSR04::OnPulse(Event event)
@@ -52,12 +75,23 @@ void HCSR04::OnPulse(Event event)
         float dist{us / 58.0f};
         if (dist > 399.0f)
             dist = 0.0f;
-        if (sensors[i].last_value)
-            sensors[i].last_value->store(sensors[i].value->load());
+        last_measurements[i] = uBit.timer.getTime();
 
-        sensors[i].value->store(dist); // sensors[i].filter.AddValueAndMean(dist);
+        // Queue the median of the last three echoes, dropped if the control loop has not polled
+        // in a while
+        sensor.samples->Push(
+            {.time = last_measurements[i], .distance = sensor.filter.AddValueAndMedian(dist)});
 
-        last_measurements[i] = uBit.timer.getTime();
+        uint32_t primask{__get_PRIMASK()};
+        __disable_irq();
+
+        // Trigger the next group once the echoes of this one have faded, instead of the timeout
+        bool waiting{pending != 0};
+        pending &= ~(1u << i);
+        if (waiting && pending == 0)
+            timer->AfterMs(settle);
+
+        __set_PRIMASK(primask);
     }
 }
 
@@ -68,7 +102,7 @@ bool HCSR04::IsMeasuring()
     for (auto last_measurement : last_measurements)
     {
         // A sensor has failed to measure
-        if (time - last_measurement > measurement_interval * sensors.size())
+        if (time - last_measurement > GetCycle())
             return false;
     }
 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <atomic>
 #include <functional>
 #include <memory>
 #include <span>
@@ -8,6 +7,7 @@
 #include <MicroBit.h>
 
 #include "../Filters.h"
+#include "../HAL/Hardware.h"
 #include "../Timer.h"
 
 namespace Firmware::Drivers
@@ -19,8 +19,13 @@ namespace Firmware::Drivers
  *
  * - HC-SR04 datasheet: https://cdn.sparkfun.com/datasheets/Sensors/Proximity/HCSR04.pdf
  *
- * \attention The \p value inside of HCSR04::Sensor MUST be allocated on heap as it is updated from
- * a different fiber, otherwise issues may arrise
+ *  The sensors are triggered in groups, the sensors of a group fire together so they should face
+ * away from each other to not hear each others echoes. The next group is triggered as soon as
+ * every echo of the current group has ended and the settle time passed, or after the timeout if an
+ * echo is lost. The 10us trigger pulse is ended by a oneshot Timer instead of waiting for it.
+ *
+ * \attention The \p samples inside of HCSR04::Sensor MUST be allocated on heap as they are pushed
+ * from an interrupt, otherwise issues may arrise
  */
 
 class HCSR04
@@ -32,36 +37,53 @@ public:
         NRF52Pin &echo_pin;
         //! Pin for the trigger for sensor module
         NRF52Pin &trig_pin;
-        //! Value to update with the distance in cm
-        std::atomic<float> *value;
+        //! Queue to push the measured distances in cm to
+        HAL::SampleQueue *samples;
 
-        std::atomic<float> *last_value{nullptr};
+        //! Sensors in the same group are triggered together
+        uint8_t group{0};
 
-        Filters::MovingAverageFilter<float, 2> filter{};
+        //! Rejects single spurious echoes, fed and read from the pulse interrupt
+        Filters::MedianFilter<float, 3> filter{};
     };
 
     /*! \brief Constructor for HCSR04
-        - \p sensors is a vector of pins for *Trig* (Trigger) and a pointer to value to update
-       with a float distance in (cm) as argument
-        - \p measurement_interval How often in milliseconds a sensor should be triggered
+        - \p sensors is a vector of pins for *Trig* (Trigger) and a pointer to the queue to push
+       the float distances in (cm) to
+        - \p timeout Longest time in milliseconds to wait for the echoes of a group
+        - \p settle Time in milliseconds to let the echoes fade before triggering the next group
      */
-    HCSR04(std::vector<Sensor> sensors, uint16_t measurement_interval = 60);
+    HCSR04(std::vector<Sensor> sensors, uint16_t timeout = 60, uint16_t settle = 10);
 
-    //! Returns true if the last measurement was done within the interval
+    //! Returns true if every sensor measured within the cycle
     bool IsMeasuring();
-    inline uint16_t GetMeasurementInterval() { return measurement_interval; }
+    //! Longest time in milliseconds for every sensor to measure once
+    inline uint16_t GetCycle() { return group_count * timeout; }
 
 private:
-    //! Run a measurement
+    //! Length of the trigger pulse in us
+    static constexpr CODAL_TIMESTAMP TRIGGER_US{10};
+
+    //! Trigger the sensors of the next group
     void Run();
+    //! End the trigger pulse
+    void EndTrigger();
     //! Event handler for high pulses
     void OnPulse(Event event);
 
     std::vector<Sensor> sensors;
     std::vector<CODAL_TIMESTAMP> last_measurements;
+    //! Triggers the next group after the settle time or the timeout
     std::unique_ptr<Timer> timer;
-    uint16_t measurement_interval;
-    uint16_t idx{0};
+    //! Ends the trigger pulse
+    std::unique_ptr<Timer> trigger;
+    uint16_t timeout;
+    uint16_t settle;
+    uint8_t group_count{1};
+    //! Group to trigger next
+    uint8_t group{0};
+    //! Bitmask of the sensors still waiting for their echo
+    uint32_t pending{0};
 };
 
 }; // namespace Firmware::Drivers
@@ -5,8 +5,6 @@
 
 extern MicroBit uBit;
 
-const size_t SAMPLES_PER_FLASH{2};
-
 namespace Firmware::Drivers
 {
 
@@ -20,12 +18,30 @@ int IR::IRSink::pullRequest()
     auto buffer{source->pull()};
     auto format{source->getFormat()};
 
-    uint8_t *end = buffer.getBytes() + (buffer.length() - (buffer.length() / 2));
-    int value = StreamNormalizer::readSample[format](end);
+    // Only whole periods of the emitter, the rest would leak the ambient light into the amplitude
+    int bytes_per_sample{DATASTREAM_FORMAT_BYTES_PER_SAMPLE(format)};
+    int sample_count{buffer.length() / bytes_per_sample};
+    sample_count -= sample_count % static_cast<int>(SAMPLES_PER_FLASH);
+    if (sample_count < 1)
+        return DEVICE_OK;
+
+    // Correlate the buffer with the emitter, the ADC writes 16-bit signed samples
+    detector.Reset();
+    if (format == DATASTREAM_FORMAT_16BIT_SIGNED)
+        detector.AddValues({reinterpret_cast<const int16_t *>(buffer.getBytes()),
+                            static_cast<size_t>(sample_count)});
+    else
+    {
+        uint8_t *in{buffer.getBytes()};
+        for (int i{0}; i < sample_count; i++, in += bytes_per_sample)
+            detector.AddValue(StreamNormalizer::readSample[format](in));
+    }
+    float value{detector.Amplitude()};
 
-    // Attempt to normalise the distance
-    *sensor.value = std::clamp(
-        std::pow(std::max(value - sensor.base, 0.1f), sensor.exp) * sensor.scale, 0.0f, 20.0f);
+    // Attempt to normalise the distance, dropped if the control loop has not polled in a while
+    float distance{std::clamp(
+        std::pow(std::max(value - sensor.base, 0.1f), sensor.exp) * sensor.scale, 0.0f, 20.0f)};
+    sensor.samples->Push({.time = uBit.timer.getTime(), .distance = distance});
 
     return DEVICE_OK;
 }
@@ -38,8 +54,8 @@ IR::IR(std::vector<Sensor> sensors, NRF52Pin &emitter_pin, uint16_t sample_rate)
     // Set analog period for emitting
     emitter_pin.setAnalogPeriodUs((1'000'000 / sample_rate) * SAMPLES_PER_FLASH);
 
-    // Setup ADCs
-    for (auto &sensor : sensors)
+    // Setup ADCs, the sinks keep a reference to the Sensor so use the member
+    for (auto &sensor : this->sensors)
     {
         // Setup the ADC channel for sense pin
         auto adc{std::unique_ptr<NRF52ADCChannel>(uBit.adc.getChannel(sensor.sense_pin))};
@@ -47,22 +63,8 @@ IR::IR(std::vector<Sensor> sensors, NRF52Pin &emitter_pin, uint16_t sample_rate)
         adc->setGain(0, 1);                  // Minimize gain to get better range
         adc->enable();
 
-        // Add bandpass filter
-        auto bandpass{std::make_unique<Filters::BandpassFilter>(
-            adc->output, sample_rate / SAMPLES_PER_FLASH, 16.0f, adc->getSampleRate())};
-        bandpass->SetOutputScale(16.0f);
-
-        // Add absolute filter
-        auto abs{std::make_unique<Filters::AbsoluteFilter>(bandpass->output)};
-
-        // Add lowpass filter
-        auto lowpass{std::make_unique<codal::LowPassFilter>(abs->output, 0.01f)};
-
-        data.push_back({.adc_channel = std::move(adc),
-                        .bandpass = std::move(bandpass),
-                        .abs = std::move(abs),
-                        .sink = std::make_unique<IRSink>(lowpass.get(), sensor),
-                        .lowpass = std::move(lowpass)});
+        auto sink{std::make_unique<IRSink>(&adc->output, sensor)};
+        data.push_back({.adc_channel = std::move(adc), .sink = std::move(sink)});
     }
 }
 
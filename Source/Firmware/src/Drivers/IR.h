@@ -1,6 +1,5 @@
 #pragma once
 
-#include <atomic>
 #include <functional>
 #include <memory>
 #include <span>
@@ -8,6 +7,7 @@
 #include <MicroBit.h>
 
 #include "../Filters.h"
+#include "../HAL/Hardware.h"
 #include "../Timer.h"
 #include "../Utils.h"
 
@@ -19,19 +19,23 @@ namespace Firmware::Drivers
 
 /*! \brief IR diode based distance
  *
- * \attention The \p value inside of IR::Sensor MUST be allocated on heap as it is updated from
- * a different fiber, otherwise issues may arrise
+ * \attention The \p samples inside of IR::Sensor MUST be allocated on heap as they are pushed
+ * from a different fiber, otherwise issues may arrise
  */
 
 class IR
 {
 public:
+    //! ADC samples per period of the emitter, 8 keeps the amplitude within 7% whatever the phase
+    //! between the emitter and the ADC, see Filters::LockInDetector
+    static constexpr size_t SAMPLES_PER_FLASH{8};
+
     struct Sensor
     {
         //! Pin for IR sensor diode
         NRF52Pin &sense_pin;
-        //! Value to update with the distance in cm
-        std::atomic<float> *value;
+        //! Queue to push the measured distances in cm to
+        HAL::SampleQueue *samples;
         //! Base value (Distance when wood is obstructing on side, next to wheels)
         float base;
         //! Scale (to make it more cm like)
@@ -40,7 +44,11 @@ public:
         float exp;
     };
 
-    //! Custom codal::DataSink for IR, used to handle signal processed data and update Sensor value
+    /*! \brief Custom codal::DataSink for IR, pulls the ADC buffers and pushes the Sensor samples
+     *
+     *  Every buffer is demodulated to a single amplitude of the emitter by a
+     * Filters::LockInDetector, so the cost per channel is a pass over the samples.
+     */
     class IRSink : public codal::DataSink
     {
     public:
@@ -51,14 +59,15 @@ public:
     private:
         codal::DataSource *source;
         Sensor &sensor;
+        Filters::LockInDetector<SAMPLES_PER_FLASH> detector;
     };
 
     /*! \brief Constructor for IR
-        - \p sensors is a vector of pins for *sense* and a pointer to value to update
-       with a float distance in (cm) as argument
-        - \p sample_rate Rate in Hz to do samples
+        - \p sensors is a vector of pins for *sense* and a pointer to the queue to push the
+       float distances in (cm) to
+        - \p sample_rate Rate in Hz to do samples, the emitter flashes at a SAMPLES_PER_FLASH of it
      */
-    IR(std::vector<Sensor> sensors, NRF52Pin &emitter_pin, uint16_t sample_rate = 4800);
+    IR(std::vector<Sensor> sensors, NRF52Pin &emitter_pin, uint16_t sample_rate = 19200);
 
     inline uint16_t GetSamplingRate() { return sample_rate; }
 
@@ -66,10 +75,7 @@ private:
     struct SensorData
     {
         std::unique_ptr<NRF52ADCChannel> adc_channel;
-        std::unique_ptr<Filters::BandpassFilter> bandpass;
-        std::unique_ptr<Filters::AbsoluteFilter> abs;
         std::unique_ptr<IRSink> sink;
-        std::unique_ptr<codal::LowPassFilter> lowpass;
     };
 
     //! Run a measurement
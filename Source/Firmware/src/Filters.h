@@ -1,52 +1,171 @@
 #pragma once
 
-#include <MicroBit.h>
-#include <deque>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <numbers>
 #include <span>
+#include <type_traits>
 
 namespace Firmware::Filters
 {
 
-//! Basic BandpassFilter
-class BandpassFilter : public EffectFilter
+/*! \brief Lock-in detector of a carrier with a period of \p PERIOD samples
+ *
+ *  Correlates the samples with the cosine and sine of the carrier and gets the amplitude from the
+ * in-phase and quadrature sums, so the phase between the carrier and the sampling does not matter.
+ * Over whole periods anything not at the carrier frequency, like ambient light, sums to about 0.
+ *
+ *  The references are a Q15 table of a single period computed once. At least 3 samples per period
+ * are needed for the quadrature channel, at the Nyquist frequency the sine is 0 and the amplitude
+ * would depend on the phase. Few samples per period also alias the odd harmonics of a square
+ * carrier onto it, so samples landing on its edges change the amplitude, by up to 30% with 4 and
+ * 7% with 8 samples per period. With a \p PERIOD of 8 the references are 0, +-1 and +-sqrt(1/2),
+ * and the correlation is an add or subtract per sample.
+ */
+template <size_t PERIOD> class LockInDetector
 {
+    static_assert(PERIOD >= 3, "A carrier needs at least 3 samples per period for quadrature");
+
 public:
-    BandpassFilter(DataSource &source, float centre_hz, float bandwidth_hz, float sample_rate,
-                   bool deepCopy = true);
-    ~BandpassFilter();
+    //! Create the detector, the amplitude is multiplied by \p scale
+    LockInDetector(float scale = 1.0f) : scale{scale}
+    {
+        for (size_t i{0}; i < PERIOD; ++i)
+        {
+            float phase{2.0f * std::numbers::pi_v<float> * i / PERIOD};
+            cos[i] = static_cast<int32_t>(std::lround(std::cos(phase) * Q15));
+            sin[i] = static_cast<int32_t>(std::lround(std::sin(phase) * Q15));
+        }
+    }
 
-    virtual void applyEffect(ManagedBuffer inputBuffer, ManagedBuffer outputBuffer,
-                             int format) override;
+    //! Add a single sample \p x
+    inline void AddValue(int32_t x)
+    {
+        in_phase += static_cast<int64_t>(cos[phase]) * x;
+        quadrature += static_cast<int64_t>(sin[phase]) * x;
+        phase = phase + 1 == PERIOD ? 0 : phase + 1;
+        count++;
+    }
 
-    //! Set the value the output is multiplyed by before returning to an int
-    inline void SetOutputScale(float scale) { this->scale = scale; }
+    //! Add the \p samples, should be whole periods for the best rejection
+    inline void AddValues(std::span<const int16_t> samples)
+    {
+        if constexpr (PERIOD == 8)
+        {
+            size_t i{0};
+            for (; i < samples.size() && phase != 0; ++i)
+                AddValue(samples[i]);
 
-    //! Output datastream
-    DataStream output;
+            // Sums of the samples at the +-1 and at the +-sqrt(1/2) references
+            int32_t i_axis{0};
+            int32_t i_diagonal{0};
+            int32_t q_axis{0};
+            int32_t q_diagonal{0};
+            size_t periods{(samples.size() - i) / 8};
+            for (size_t end{i + (periods * 8)}; i < end; i += 8)
+            {
+                const int16_t *x{&samples[i]};
+                int32_t b{x[1] - x[5]};
+                int32_t d{x[3] - x[7]};
+                i_axis += x[0] - x[4];
+                i_diagonal += b - d;
+                q_axis += x[2] - x[6];
+                q_diagonal += b + d;
+            }
+            in_phase += (static_cast<int64_t>(i_axis) * Q15) +
+                        (static_cast<int64_t>(i_diagonal) * cos[1]);
+            quadrature += (static_cast<int64_t>(q_axis) * Q15) +
+                          (static_cast<int64_t>(q_diagonal) * sin[1]);
+            count += periods * 8;
+
+            for (; i < samples.size(); ++i)
+                AddValue(samples[i]);
+        }
+        else
+        {
+            for (int16_t x : samples)
+                AddValue(x);
+        }
+    }
+
+    //! Get the scaled amplitude of the carrier in the samples added since the last Reset
+    inline float Amplitude() const
+    {
+        if (count == 0)
+            return 0.0f;
+
+        // A sinusoid splits equally between the positive and negative frequency
+        float i{static_cast<float>(in_phase)};
+        float q{static_cast<float>(quadrature)};
+        return std::sqrt((i * i) + (q * q)) * 2.0f * scale / (static_cast<float>(count) * Q15);
+    }
+
+    //! Clear the sums, e.g. before the next buffer
+    inline void Reset()
+    {
+        in_phase = 0;
+        quadrature = 0;
+        phase = 0;
+        count = 0;
+    }
 
 private:
-    float centre_hz;
-    float bandwidth_hz;
-    float sample_rate;
-    float scale{1.0f};
+    static constexpr int32_t Q15{1 << 15};
+
+    float scale;
+    std::array<int32_t, PERIOD> cos{};
+    std::array<int32_t, PERIOD> sin{};
+    int64_t in_phase{0};
+    int64_t quadrature{0};
+    size_t phase{0};
+    size_t count{0};
 };
 
-//! Make all the buffer values to absolute (positive)
-class AbsoluteFilter : public EffectFilter
+/*! \brief Fixed-capacity window of the last \p SIZE values, used by the windowed filters
+ *
+ *  The values are kept in a ring buffer inside of the object, so adding a value never allocates
+ * and takes constant time.
+ */
+template <typename T, size_t SIZE> class Window
 {
+    static_assert(SIZE > 0, "Window must hold at least one value");
+
 public:
-    AbsoluteFilter(DataSource &source, bool deepCopy = false);
-    ~AbsoluteFilter();
+    //! Add \p value, returns true and sets \p evicted to the oldest value if the window was full
+    inline bool Push(T value, T &evicted)
+    {
+        bool full{count == SIZE};
+        if (full)
+            evicted = values[next];
+        else
+            count++;
+
+        values[next] = value;
+        next = next + 1 == SIZE ? 0 : next + 1;
+        return full;
+    }
+
+    //! Get the \p i th oldest value
+    inline const T &operator[](size_t i) const { return values[(next + SIZE - count + i) % SIZE]; }
 
-    virtual void applyEffect(ManagedBuffer inputBuffer, ManagedBuffer outputBuffer,
-                             int format) override;
+    inline size_t Size() const { return count; }
+    inline bool Full() const { return count == SIZE; }
+    inline void Clear() { count = 0; }
 
-    //! Output DataStream
-    DataStream output;
+private:
+    std::array<T, SIZE> values{};
+    //! Index the next value is written to
+    size_t next{0};
+    size_t count{0};
 };
 
 /*! \brief Filter to get average/mean of \p T over \p SIZE
+ *
+ *  Keeps a running sum, so both adding a value and getting the Mean take constant time. For
+ * floating point the sum is recalculated every \p SIZE values so rounding errors do not build up.
  */
 template <typename T, size_t SIZE> class MovingAverageFilter
 {
@@ -56,46 +175,230 @@ public:
     //! Add \p value to the moving average
     inline void AddValue(T value)
     {
-        while (queue.size() >= SIZE)
-            queue.pop_front();
+        T evicted;
+        if (window.Push(value, evicted))
+            sum -= evicted;
+        sum += value;
 
-        queue.push_back(value);
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (++added == SIZE)
+            {
+                added = 0;
+                sum = 0;
+                for (size_t i{0}; i < window.Size(); ++i)
+                    sum += window[i];
+            }
+        }
     }
 
-    //! Calculate the Mean of the queue
-    inline T Mean()
+    //! Get the Mean of the values, 0 if empty
+    inline T Mean() const
     {
-        T sum = 0.0;
-        for (T d : queue)
-            sum += d;
+        if (window.Size() == 0)
+            return T{};
+
+        return static_cast<T>(sum / static_cast<Sum>(window.Size()));
+    }
 
-        return sum / queue.size();
+    //! Add the \p value and get latest Mean
+    inline T AddValueAndMean(T value)
+    {
+        AddValue(value);
+        return Mean();
     }
 
-    //! Assuming \p T is in degrees, get the mean of all angles
-    inline T MeanDegrees()
+    inline size_t Size() const { return window.Size(); }
+    inline void Clear()
     {
-        float x{0.0};
-        float y{0.0};
+        window.Clear();
+        sum = 0;
+        added = 0;
+    }
 
-        for (T v : queue)
+private:
+    using Sum = std::conditional_t<std::is_integral_v<T>, int64_t, T>;
+
+    Window<T, SIZE> window;
+    Sum sum{0};
+    //! Values added since the sum was last recalculated
+    size_t added{0};
+};
+
+/*! \brief Filter to get the circular mean of angles in degrees over \p SIZE
+ *
+ *  Keeps the sine and cosine of every angle in the window and their running sums, so adding an
+ * angle takes a single sin and cos and getting the mean a single atan2. The angles are averaged as
+ * unit vectors, so 350 and 10 average to 0 instead of 180.
+ */
+template <size_t SIZE> class CircularMeanFilter
+{
+public:
+    CircularMeanFilter() {}
+
+    //! Add the angle \p degrees
+    inline void AddValue(float degrees)
+    {
+        float rad{degrees * std::numbers::pi_v<float> / 180.0f};
+        Vector vector{std::cos(rad), std::sin(rad)};
+
+        Vector evicted;
+        if (window.Push(vector, evicted))
         {
-            x += std::cos(v * std::numbers::pi / 180.0f);
-            y += std::sin(v * std::numbers::pi / 180.0f);
+            x -= evicted.x;
+            y -= evicted.y;
         }
+        x += vector.x;
+        y += vector.y;
 
-        return std::atan2(y, x) * 180.0f / std::numbers::pi;
+        // Recalculate the sums to not build up rounding errors
+        if (++added == SIZE)
+        {
+            added = 0;
+            x = 0.0f;
+            y = 0.0f;
+            for (size_t i{0}; i < window.Size(); ++i)
+            {
+                x += window[i].x;
+                y += window[i].y;
+            }
+        }
     }
 
-    //! Add the \p value and get latest Mean
-    inline T AddValueAndMean(T value)
+    //! Get the mean of the angles in degrees within (-180, 180], 0 if empty
+    inline float MeanDegrees() const
+    {
+        return std::atan2(y, x) * 180.0f / std::numbers::pi_v<float>;
+    }
+
+    //! Add the angle \p degrees and get latest MeanDegrees
+    inline float AddValueAndMean(float degrees)
+    {
+        AddValue(degrees);
+        return MeanDegrees();
+    }
+
+    inline size_t Size() const { return window.Size(); }
+    inline void Clear()
+    {
+        window.Clear();
+        x = 0.0f;
+        y = 0.0f;
+        added = 0;
+    }
+
+private:
+    struct Vector
+    {
+        float x;
+        float y;
+    };
+
+    Window<Vector, SIZE> window;
+    float x{0.0f};
+    float y{0.0f};
+    size_t added{0};
+};
+
+/*! \brief Filter to get the median of \p T over \p SIZE
+ *
+ *  A sorted copy of the window is kept next to it, where the oldest value is removed and the new
+ * value inserted in place with a binary search. Getting the Median takes constant time and adding a
+ * value moves at most \p SIZE values, meant for small windows rejecting single outliers.
+ */
+template <typename T, size_t SIZE> class MedianFilter
+{
+public:
+    MedianFilter() {}
+
+    //! Add \p value to the window
+    inline void AddValue(T value)
+    {
+        size_t size{window.Size()};
+
+        T evicted;
+        if (window.Push(value, evicted))
+        {
+            auto it{std::lower_bound(sorted.begin(), sorted.begin() + size, evicted)};
+            std::move(it + 1, sorted.begin() + size, it);
+            size--;
+        }
+
+        auto it{std::upper_bound(sorted.begin(), sorted.begin() + size, value)};
+        std::move_backward(it, sorted.begin() + size, sorted.begin() + size + 1);
+        *it = value;
+    }
+
+    //! Get the median of the values, the mean of the middle two for an even count, 0 if empty
+    inline T Median() const
+    {
+        size_t size{window.Size()};
+        if (size == 0)
+            return T{};
+        if (size % 2 == 1)
+            return sorted[size / 2];
+
+        return (sorted[(size / 2) - 1] + sorted[size / 2]) / 2;
+    }
+
+    //! Add the \p value and get latest Median
+    inline T AddValueAndMedian(T value)
     {
         AddValue(value);
-        return Mean();
+        return Median();
+    }
+
+    inline size_t Size() const { return window.Size(); }
+    inline void Clear() { window.Clear(); }
+
+private:
+    Window<T, SIZE> window;
+    std::array<T, SIZE> sorted{};
+};
+
+/*! \brief First-order low-pass filter `y += alpha * (x - y)` of \p T
+ *
+ *  Constant time and a single value of state. The first value added is used as is.
+ */
+template <typename T> class ExponentialFilter
+{
+public:
+    //! Create the filter with the smoothing factor \p alpha in (0, 1], 1 is unfiltered
+    ExponentialFilter(float alpha) : alpha{alpha} {}
+
+    //! Add \p value to the filter
+    inline void AddValue(T value)
+    {
+        if (!initialised)
+        {
+            this->value = value;
+            initialised = true;
+            return;
+        }
+
+        this->value += static_cast<T>(alpha * (value - this->value));
+    }
+
+    //! Get the filtered value, 0 if nothing is added
+    inline T Value() const { return value; }
+
+    //! Add the \p value and get the latest Value
+    inline T AddValueAndValue(T value)
+    {
+        AddValue(value);
+        return Value();
+    }
+
+    inline void Clear()
+    {
+        value = T{};
+        initialised = false;
     }
 
 private:
-    std::deque<T> queue;
+    float alpha;
+    T value{};
+    bool initialised{false};
 };
 
 }; // namespace Firmware::Filters
@@ -0,0 +1,50 @@
+#include "Codal.h"
+
+namespace Firmware::HAL
+{
+
+CodalHardware::CodalHardware(MicroBit &uBit, Drivers::DFR0548 *driver) : uBit{uBit}, driver{driver}
+{
+    // Front and back face away from each other, so they are triggered together
+    std::vector<Drivers::HCSR04::Sensor> sensor_pins = {
+        {.echo_pin = uBit.io.P13,
+         .trig_pin = uBit.io.P14,
+         .samples = &GetQueue(Sensor::Front),
+         .group = 0},
+        {.echo_pin = uBit.io.P15,
+         .trig_pin = uBit.io.P16,
+         .samples = &GetQueue(Sensor::Back),
+         .group = 0}};
+
+    // Measured as base 360 and scale 0.01 with the bandpass, absolute and lowpass chain, which read
+    // 8 per ADC step between the emitter on and off. The lock-in detector reads 0.653 per step, so
+    // the base is divided and the scale multiplied by 12.25 to the power of exp
+    std::vector<Drivers::IR::Sensor> IR_pins = {
+        {.sense_pin = uBit.io.P1,
+         .samples = &GetQueue(Sensor::Left),
+         .base = 29.4f,
+         .scale = 0.193f,
+         .exp = 1.181f},
+        {.sense_pin = uBit.io.P2,
+         .samples = &GetQueue(Sensor::Right),
+         .base = 29.4f,
+         .scale = 0.193f,
+         .exp = 1.181f}};
+
+    ultrasonics = std::make_unique<Drivers::HCSR04>(sensor_pins, 60, 10);
+    IRs = std::make_unique<Drivers::IR>(IR_pins, uBit.io.P0);
+    sensor_cycle = ultrasonics->GetCycle();
+}
+
+Timestamp CodalHardware::Now() { return uBit.timer.getTime(); }
+
+void CodalHardware::Sleep(uint32_t ms) { fiber_sleep(ms); }
+
+uint32_t CodalHardware::GetSensorCycle() { return sensor_cycle; }
+
+void CodalHardware::SetMotors(int16_t m1, int16_t m2, int16_t m3, int16_t m4)
+{
+    driver->SetMotors(m1, m2, m3, m4);
+}
+
+} // namespace Firmware::HAL
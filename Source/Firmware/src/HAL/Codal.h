@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+
+#include <MicroBit.h>
+
+#include "../Drivers/DFR0548.h"
+#include "../Drivers/HCSR04.h"
+#include "../Drivers/IR.h"
+#include "Hardware.h"
+
+namespace Firmware::HAL
+{
+
+/*! \brief Hardware of the Mouse on the micro:bit v2 using CODAL
+ *
+ *  Owns the HC-SR04 and IR drivers measuring the distances and writes the motor output to the
+ * DFR0548.
+ *
+ * \attention Must be allocated on heap, as the drivers push the samples from interrupts and a
+ * different fiber
+ */
+class CodalHardware : public Hardware
+{
+public:
+    CodalHardware(MicroBit &uBit, Drivers::DFR0548 *driver);
+
+    Timestamp Now() override;
+    void Sleep(uint32_t ms) override;
+
+    uint32_t GetSensorCycle() override;
+
+    void SetMotors(int16_t m1, int16_t m2, int16_t m3, int16_t m4) override;
+
+private:
+    MicroBit &uBit;
+    Drivers::DFR0548 *driver;
+    std::unique_ptr<Drivers::HCSR04> ultrasonics;
+    std::unique_ptr<Drivers::IR> IRs;
+    uint32_t sensor_cycle;
+};
+
+} // namespace Firmware::HAL
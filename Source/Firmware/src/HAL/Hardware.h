@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <Core/SpscQueue.h>
+
+#include "../Filters.h"
+
+namespace Firmware::HAL
+{
+
+//! Time in ms since start, matching CODAL_TIMESTAMP
+using Timestamp = uint64_t;
+
+//! The distance sensors of the Mouse, as mounted with the front facing forward
+enum class Sensor : uint8_t
+{
+    //! Front HC-SR04
+    Front,
+    //! Back HC-SR04
+    Back,
+    //! Left IR
+    Left,
+    //! Right IR
+    Right,
+};
+
+//! A distance measured by a sensor and when it was measured
+struct Sample
+{
+    //! Time in ms the measurement ended
+    Timestamp time{0};
+    //! Distance in cm
+    float distance{0.0f};
+};
+
+//! Samples measured by a driver, waiting for the control loop to Hardware::Poll them
+using SampleQueue = Core::SpscQueue<Sample, 16>;
+
+/*! \brief Hardware abstraction of everything the Mouse2 control loop uses
+ *
+ *  Covers the clock, sleeping, the distance sensors and the motor output, so Mouse2 only depends
+ * on this interface. CodalHardware implements it on the micro:bit, while HostHardware implements
+ * it on desktop with a virtual clock, so the same control loop can run faster than real time.
+ *
+ *  The drivers push every measurement with its time into the SampleQueue of the sensor, which may
+ * happen from an interrupt. Poll moves them into a short history per sensor from the control loop,
+ * so no measurement between two iterations is lost and the age of every distance is known.
+ */
+class Hardware
+{
+public:
+    virtual ~Hardware() = default;
+
+    //! Get the time in ms since start
+    virtual Timestamp Now() = 0;
+    //! Sleep for \p ms, 0 only yields to the other fibers
+    virtual void Sleep(uint32_t ms) = 0;
+
+    //! Count of the latest samples kept per sensor
+    static constexpr size_t HISTORY{8};
+
+    //! Move the samples queued since the last call into the history of every sensor, returns the
+    //! count moved, only call from the control loop
+    inline size_t Poll()
+    {
+        size_t count{0};
+        for (size_t i{0}; i < queues.size(); ++i)
+        {
+            while (auto sample{queues[i].Pop()})
+            {
+                Sample evicted;
+                histories[i].Push(*sample, evicted);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    //! Get the sample of \p sensor \p age samples before the latest one, an empty sample at time
+    //! 0 if there are not that many
+    inline Sample GetSample(Sensor sensor, size_t age = 0) const
+    {
+        auto &history{histories[static_cast<size_t>(sensor)]};
+        if (age >= history.Size())
+            return {};
+        return history[history.Size() - 1 - age];
+    }
+    //! Get the count of samples in the history of \p sensor
+    inline size_t GetSampleCount(Sensor sensor) const
+    {
+        return histories[static_cast<size_t>(sensor)].Size();
+    }
+    //! Get the latest distance in cm measured by \p sensor
+    inline float GetDistance(Sensor sensor) const { return GetSample(sensor).distance; }
+    //! Get the distance in cm measured by \p sensor before the latest one
+    inline float GetLastDistance(Sensor sensor) const { return GetSample(sensor, 1).distance; }
+
+    //! Get the time in ms for every distance sensor to have measured at least once
+    virtual uint32_t GetSensorCycle() = 0;
+
+    //! Set the speeds `[-4095, 4095]` of all four motors, see Drivers::DFR0548
+    virtual void SetMotors(int16_t m1, int16_t m2, int16_t m3, int16_t m4) = 0;
+    //! Stop all the motors
+    inline void StopMotors() { SetMotors(0, 0, 0, 0); }
+
+protected:
+    //! Get the queue the driver of \p sensor pushes its samples to
+    inline SampleQueue &GetQueue(Sensor sensor) { return queues[static_cast<size_t>(sensor)]; }
+
+private:
+    std::array<SampleQueue, 4> queues;
+    std::array<Filters::Window<Sample, HISTORY>, 4> histories;
+};
+
+} // namespace Firmware::HAL
@@ -0,0 +1,24 @@
+#include "Host.h"
+
+namespace Firmware::HAL
+{
+
+HostHardware::HostHardware(uint32_t sensor_cycle) : sensor_cycle{sensor_cycle} {}
+
+void HostHardware::SetMotors(int16_t m1, int16_t m2, int16_t m3, int16_t m4)
+{
+    motors = {m1, m2, m3, m4};
+}
+
+void HostHardware::Advance(Timestamp ms) { time += ms; }
+
+void HostHardware::SetDistance(Sensor sensor, float distance)
+{
+    // Only a single thread on desktop, so popping as the producer is safe
+    auto &queue{GetQueue(sensor)};
+    if (queue.Size() == queue.Capacity())
+        queue.Pop();
+    queue.Push({.time = time, .distance = distance});
+}
+
+} // namespace Firmware::HAL
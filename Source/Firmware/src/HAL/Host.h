@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+
+#include "Hardware.h"
+
+namespace Firmware::HAL
+{
+
+/*! \brief Hardware of the Mouse on desktop with a virtual clock
+ *
+ *  Time only passes with Advance or when the control loop sleeps, so Mouse2 can be driven as fast
+ * as the host allows:
+ *
+ *  ```cpp
+ *  hardware.Advance(dt);
+ *  mouse.Run(hardware.Now(), dt);
+ *  ```
+ *
+ *  The distances are set from outside with SetDistance and read after Poll, and the last motor
+ * output is kept for reading with GetMotors.
+ */
+class HostHardware : public Hardware
+{
+public:
+    //! Create the hardware where every distance sensor measures within \p sensor_cycle ms
+    HostHardware(uint32_t sensor_cycle = 120);
+
+    inline Timestamp Now() override { return time; }
+    inline void Sleep(uint32_t ms) override { Advance(ms); }
+
+    inline uint32_t GetSensorCycle() override { return sensor_cycle; }
+
+    void SetMotors(int16_t m1, int16_t m2, int16_t m3, int16_t m4) override;
+
+    //! Advance the virtual clock by \p ms, override to update a simulated world as time passes
+    virtual void Advance(Timestamp ms);
+    //! Queue the \p distance in cm measured by \p sensor now, dropping the oldest queued sample if
+    //! the control loop has not polled in a while
+    void SetDistance(Sensor sensor, float distance);
+    //! Get the speeds of the four motors last set
+    inline const std::array<int16_t, 4> &GetMotors() const noexcept { return motors; }
+
+protected:
+    Timestamp time{0};
+
+private:
+    uint32_t sensor_cycle;
+    std::array<int16_t, 4> motors{};
+};
+
+} // namespace Firmware::HAL
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include "Physics.h"
+
+namespace Firmware::HAL
+{
+
+static constexpr float DEG2RAD{std::numbers::pi_v<float> / 180.0f};
+static constexpr float INF{std::numeric_limits<float>::infinity()};
+
+PhysicsHardware::PhysicsHardware(Core::Maze &maze) : PhysicsHardware(maze, Model{}) {}
+
+PhysicsHardware::PhysicsHardware(Core::Maze &maze, Model model)
+    : HostHardware(model.ultrasonic_timeout), walls(maze), model{model}, x{model.tile / 2},
+      y{model.tile / 2}
+{
+    // Measure both HC-SR04 before starting
+    Measure();
+}
+
+void PhysicsHardware::Advance(Timestamp ms)
+{
+    // Step the physics a ms at a time
+    for (Timestamp i{0}; i < ms; ++i)
+    {
+        time++;
+        Integrate(0.001f);
+        Measure();
+    }
+}
+
+void PhysicsHardware::Integrate(float seconds)
+{
+    // Inverse of the mixing in Mouse2::SetMotors, M1 left-back, M2 left-front, M3 right-back and
+    // M4 right-front
+    auto &motors{GetMotors()};
+    float m1{motors[0] / 4095.0f};
+    float m2{motors[1] / 4095.0f};
+    float m3{motors[2] / 4095.0f};
+    float m4{motors[3] / 4095.0f};
+
+    float forward{(m1 + m2 + m3 + m4) / 4.0f};
+    float right{(-m1 + m2 + m3 - m4) / 4.0f};
+    float rot{(m1 + m2 - m3 - m4) / 4.0f};
+
+    // First-order response of the motors
+    float alpha{1.0f - std::exp(-seconds / model.response)};
+    speed += ((forward * model.max_speed) - speed) * alpha;
+    strafe += ((right * model.max_speed) - strafe) * alpha;
+    rotation += ((rot * model.max_rotation) - rotation) * alpha;
+
+    float next_heading{heading + (rotation * seconds)};
+    float rad{next_heading * DEG2RAD};
+    float next_x{x + (((std::sin(rad) * speed) + (std::cos(rad) * strafe)) * seconds)};
+    float next_y{y + (((std::cos(rad) * speed) - (std::sin(rad) * strafe)) * seconds)};
+
+    // Stop dead on a collision
+    if (Overlaps(next_x, next_y, next_heading))
+    {
+        collided = true;
+        speed = 0.0f;
+        strafe = 0.0f;
+        rotation = 0.0f;
+        return;
+    }
+
+    x = next_x;
+    y = next_y;
+    heading = std::fmod(next_heading + 360.0f, 360.0f);
+}
+
+void PhysicsHardware::Measure()
+{
+    // Every IR distance is the average over an ADC buffer, known once the buffer is full
+    ir_sums[0] += Distance(0.0f, -model.width / 2, -90.0f, model.ir_range);
+    ir_sums[1] += Distance(0.0f, model.width / 2, 90.0f, model.ir_range);
+    ir_count++;
+    if (time >= next_ir)
+    {
+        SetDistance(Sensor::Left, ir_sums[0] / ir_count);
+        SetDistance(Sensor::Right, ir_sums[1] / ir_count);
+        ir_sums = {};
+        ir_count = 0;
+        next_ir = time + model.ir_period;
+    }
+
+    // Like Drivers::HCSR04 every distance is pushed when its echo ends
+    const std::array<Sensor, 2> sensors{Sensor::Front, Sensor::Back};
+    for (size_t i{0}; i < sensors.size(); ++i)
+    {
+        if (echo_pending[i] && time >= echo_ends[i])
+        {
+            SetDistance(sensors[i], ultrasonic_filters[i].AddValueAndMedian(echo_distances[i]));
+            echo_pending[i] = false;
+        }
+    }
+
+    if (time < next_ultrasonic)
+        return;
+
+    // The HC-SR04 are triggered together, again once the longer echo has settled
+    const std::array<float, 2> distances{
+        Distance(model.length / 2, 0.0f, 0.0f, model.ultrasonic_range),
+        Distance(-model.length / 2, 0.0f, 180.0f, model.ultrasonic_range)};
+    Timestamp longest{0};
+    for (size_t i{0}; i < sensors.size(); ++i)
+    {
+        float distance{distances[i]};
+        // The echo takes 58us per cm, one ending after the timeout is lost
+        auto echo{static_cast<Timestamp>(distance * 58.0f / 1000.0f)};
+        if (echo >= model.ultrasonic_timeout)
+            continue;
+
+        echo_distances[i] = distance >= model.ultrasonic_range ? 0.0f : distance;
+        echo_ends[i] = time + echo;
+        echo_pending[i] = true;
+        longest = std::max(longest, echo);
+    }
+
+    next_ultrasonic =
+        time + std::min<Timestamp>(longest + model.ultrasonic_settle, model.ultrasonic_timeout);
+}
+
+float PhysicsHardware::Distance(float forward, float right, float angle, float range) const
+{
+    float rad{heading * DEG2RAD};
+    float sensor_x{x + (std::sin(rad) * forward) + (std::cos(rad) * right)};
+    float sensor_y{y + (std::cos(rad) * forward) - (std::sin(rad) * right)};
+    return Cast(sensor_x, sensor_y, heading + angle, range);
+}
+
+float PhysicsHardware::Cast(float x, float y, float heading, float range) const
+{
+    float tile{model.tile};
+    float half{model.wall / 2};
+    float rad{heading * DEG2RAD};
+    float dx{std::sin(rad)};
+    float dy{std::cos(rad)};
+
+    // Walk the grid lines crossed by the ray in order
+    int column{static_cast<int>(std::floor(x / tile))};
+    int row{static_cast<int>(std::floor(y / tile))};
+    float next_x{dx != 0.0f ? ((((column + (dx > 0.0f)) * tile) - x) / dx) : INF};
+    float next_y{dy != 0.0f ? ((((row + (dy > 0.0f)) * tile) - y) / dy) : INF};
+    float delta_x{dx != 0.0f ? tile / std::abs(dx) : INF};
+    float delta_y{dy != 0.0f ? tile / std::abs(dy) : INF};
+
+    while (true)
+    {
+        bool vertical{next_x < next_y};
+        float t{vertical ? next_x : next_y};
+        float cos{vertical ? std::abs(dx) : std::abs(dy)};
+        // Distance to the face of the wall before the line
+        float face{t - (half / cos)};
+        if (face >= range)
+            return range;
+
+        float along;
+        bool wall;
+        if (vertical)
+        {
+            along = y + (dy * t);
+            wall = VerticalWall(column + (dx > 0.0f),
+                                static_cast<int>(std::floor(along / tile)));
+            column += dx > 0.0f ? 1 : -1;
+            next_x += delta_x;
+        }
+        else
+        {
+            along = x + (dx * t);
+            wall = HorizontalWall(static_cast<int>(std::floor(along / tile)),
+                                  row + (dy > 0.0f));
+            row += dy > 0.0f ? 1 : -1;
+            next_y += delta_y;
+        }
+
+        // Posts are at every corner, the walls have a seam next to them
+        float corner{std::abs(along - (std::round(along / tile) * tile))};
+        if (corner <= half)
+            return std::clamp(face, 0.0f, range);
+        if (wall)
+        {
+            if (corner < half + model.seam_width)
+                face += model.seam_depth / cos;
+            return std::clamp(face, 0.0f, range);
+        }
+    }
+}
+
+bool PhysicsHardware::Overlaps(float x, float y, float heading) const
+{
+    float rad{heading * DEG2RAD};
+    float sin{std::sin(rad)};
+    float cos{std::cos(rad)};
+    float front{model.length / 2};
+    float side{model.width / 2};
+
+    // Corners and the middle of every edge of the body
+    const float points[8][2] = {{front, side}, {front, 0.0f}, {front, -side}, {0.0f, side},
+                                {0.0f, -side}, {-front, side}, {-front, 0.0f}, {-front, -side}};
+    for (auto &point : points)
+    {
+        float point_x{x + (sin * point[0]) + (cos * point[1])};
+        float point_y{y + (cos * point[0]) - (sin * point[1])};
+        if (InWall(point_x, point_y))
+            return true;
+    }
+
+    return false;
+}
+
+bool PhysicsHardware::InWall(float x, float y) const
+{
+    float tile{model.tile};
+    float half{model.wall / 2};
+    if (x < 0.0f || y < 0.0f || x > walls.GetWidth() * tile || y > walls.GetHeight() * tile)
+        return true;
+
+    int column{static_cast<int>(x / tile)};
+    int row{static_cast<int>(y / tile)};
+    float local_x{x - (column * tile)};
+    float local_y{y - (row * tile)};
+
+    // The closest lines to the point
+    bool near_x{std::min(local_x, tile - local_x) < half};
+    bool near_y{std::min(local_y, tile - local_y) < half};
+    int line_x{local_x < tile / 2 ? column : column + 1};
+    int line_y{local_y < tile / 2 ? row : row + 1};
+
+    if (near_x && near_y)
+        return true;
+    if (near_x && VerticalWall(line_x, row))
+        return true;
+    if (near_y && HorizontalWall(column, line_y))
+        return true;
+
+    return false;
+}
+
+bool PhysicsHardware::VerticalWall(int column, int row) const
+{
+    if (column <= 0 || column >= walls.GetWidth() || row < 0 || row >= walls.GetHeight())
+        return true;
+
+    return walls.HasWall(column, row, Core::Direction::Left);
+}
+
+bool PhysicsHardware::HorizontalWall(int column, int row) const
+{
+    if (row <= 0 || row >= walls.GetHeight() || column < 0 || column >= walls.GetWidth())
+        return true;
+
+    return walls.HasWall(column, row, Core::Direction::Down);
+}
+
+} // namespace Firmware::HAL
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <Core/Maze.h>
+#include <Core/MazeBitboard.h>
+
+#include "Host.h"
+
+namespace Firmware::HAL
+{
+
+/*! \brief HostHardware simulating the Mouse driving inside of a Core::Maze
+ *
+ *  The motor speeds are turned into body motion using the inverse of the mecanum mixing done by
+ * Mouse2::SetMotors, with a first-order lag for the response of the motors. The distances are
+ * synthesized by casting rays from every sensor against the walls and posts of the maze, including
+ * the seams between walls and posts which Mouse2 uses to detect tile changes. Like the drivers, an
+ * IR distance is the average over its ADC buffer and a HC-SR04 distance is pushed when its echo
+ * ends, both stamped with the time they are known. The body is checked against the walls and posts,
+ * stopping the Mouse on a collision.
+ *
+ *  Positions are in cm from the outer corner of tile 0,0 and the heading is in degrees with 0
+ * being up and 90 right, same as Core::Mouse. The Mouse starts in the centre of tile 0,0 facing up.
+ *
+ *  None of the constants are measured on the robot yet, they are estimates and the turn rate is
+ * picked so the open-loop turn of Mouse2 ends up at 90 degrees. No run of Mouse2 finishes on the
+ * generated 16x16 mazes, most lose track of their tile where a straight has no side walls and
+ * then hit a wall.
+ *
+ * \attention Only available in non-firmware builds
+ */
+class PhysicsHardware : public HostHardware
+{
+public:
+    //! Dimensions of the maze and body, and the response of the motors and sensors
+    struct Model
+    {
+        //! Distance between the centres of the posts
+        float tile{18.0f};
+        //! Thickness of the walls and posts
+        float wall{1.2f};
+        //! Width of the seam between a wall and a post
+        float seam_width{0.4f};
+        //! Depth of the seam between a wall and a post
+        float seam_depth{0.5f};
+        //! Width of the body between the IR sensors
+        float width{7.8f};
+        //! Length of the body between the HC-SR04 sensors
+        float length{10.0f};
+        //! Speed in cm/s at full motor output
+        float max_speed{30.0f};
+        //! Rotation in degrees/s at full motor output, the open-loop profile of Mouse2::MoveTurn
+        //! turns 90 degrees with it
+        float max_rotation{160.0f};
+        //! Time constant in seconds of the motor response
+        float response{0.05f};
+        //! Largest distance in cm reported by the IR sensors
+        float ir_range{20.0f};
+        //! Time in ms averaged into every IR distance, about one ADC buffer of Drivers::IR
+        uint32_t ir_period{13};
+        //! Largest distance in cm measured by the HC-SR04 sensors, 0 is reported beyond
+        float ultrasonic_range{399.0f};
+        //! Longest time in ms of a HC-SR04 measurement, both sensors measure together
+        uint32_t ultrasonic_timeout{60};
+        //! Time in ms waited after the echoes before the HC-SR04 measure again
+        uint32_t ultrasonic_settle{10};
+    };
+
+    //! Create the hardware inside of the \p maze with the default Model
+    PhysicsHardware(Core::Maze &maze);
+    //! Create the hardware inside of the \p maze with the \p model
+    PhysicsHardware(Core::Maze &maze, Model model);
+
+    //! Advance the virtual clock by \p ms, moving the body and measuring the distances
+    void Advance(Timestamp ms) override;
+
+    //! Get the true x-position in cm
+    inline float X() const noexcept { return x; }
+    //! Get the true y-position in cm
+    inline float Y() const noexcept { return y; }
+    //! Get the true heading in degrees
+    inline float Heading() const noexcept { return heading; }
+    //! Get the tile column the centre of the body is in
+    inline int TileX() const noexcept { return static_cast<int>(x / model.tile); }
+    //! Get the tile row the centre of the body is in
+    inline int TileY() const noexcept { return static_cast<int>(y / model.tile); }
+    //! Get if the body has hit a wall or post
+    inline bool HasCollided() const noexcept { return collided; }
+
+    //! Get the distance in cm from \p x, \p y to the closest wall or post towards \p heading
+    float Cast(float x, float y, float heading, float range) const;
+
+private:
+    Core::MazeBitboard walls;
+    Model model;
+
+    float x;
+    float y;
+    float heading{0.0f};
+    //! Velocities in the body frame, cm/s and degrees/s
+    float speed{0.0f};
+    float strafe{0.0f};
+    float rotation{0.0f};
+    bool collided{false};
+
+    //! Sums of the IR distances over the current period, left and right
+    std::array<float, 2> ir_sums{};
+    uint32_t ir_count{0};
+    Timestamp next_ir{0};
+
+    Timestamp next_ultrasonic{0};
+    //! Median of the last three HC-SR04 measurements like Drivers::HCSR04, front and back
+    std::array<Filters::MedianFilter<float, 3>, 2> ultrasonic_filters;
+    //! HC-SR04 distances waiting for their echoes, and the time the echoes end
+    std::array<float, 2> echo_distances{};
+    std::array<Timestamp, 2> echo_ends{};
+    std::array<bool, 2> echo_pending{};
+
+    //! Move the body for \p seconds
+    void Integrate(float seconds);
+    //! Measure the IR sensors, end the HC-SR04 echoes due and trigger them again once settled
+    void Measure();
+    //! Get the distance measured by the sensor at \p forward, \p right from the centre of the body
+    //! facing \p angle relative to the heading
+    float Distance(float forward, float right, float angle, float range) const;
+    //! Check if the body at \p x, \p y facing \p heading overlaps a wall or post
+    bool Overlaps(float x, float y, float heading) const;
+    //! Check if the point at \p x, \p y is inside of a wall or post
+    bool InWall(float x, float y) const;
+    //! Check if there is a wall on the vertical line \p column in \p row
+    bool VerticalWall(int column, int row) const;
+    //! Check if there is a wall on the horizontal line \p row in \p column
+    bool HorizontalWall(int column, int row) const;
+};
+
+} // namespace Firmware::HAL
@@ -2,64 +2,42 @@
 #include <cmath>
 
 #include <Core/Log.h>
+#include <Core/Profiler.h>
 
-// #define MOCK // (Mock sensors, useful to test state machine without a working robot)
 #include "Mouse2.h"
 
 namespace Firmware
 {
 
-Mouse2::Mouse2(MicroBit &uBit, Drivers::DFR0548 *driver)
-    : uBit{uBit}, driver{driver}, right_pid("r", 0.85, 0, 3)
-
+Mouse2::Mouse2(HAL::Hardware &hardware) : hardware{hardware}, right_pid("r", 0.85, 0, 3)
 {
-    std::vector<Drivers::HCSR04::Sensor> sensor_pins = {
-        {.echo_pin = uBit.io.P13, .trig_pin = uBit.io.P14, .value = &f, .last_value = &last_f},
-        {.echo_pin = uBit.io.P15, .trig_pin = uBit.io.P16, .value = &b, .last_value = &last_b}};
-
-    std::vector<Drivers::IR::Sensor> IR_pins = {
-        {.sense_pin = uBit.io.P1, .value = &l, .base = 360, .scale = 0.01f, .exp = 1.181f},
-        {.sense_pin = uBit.io.P2, .value = &r, .base = 360, .scale = 0.01f, .exp = 1.181f}};
-
-    sensor_count = sensor_pins.size();
-    prev_time_ms = uBit.timer.getTime();
-    ultrasonics = std::make_unique<Drivers::HCSR04>(sensor_pins, 60);
-    IRs = std::make_unique<Drivers::IR>(IR_pins, uBit.io.P0);
-    measurement_interval_ms = ultrasonics->GetMeasurementInterval();
+    prev_time_ms = hardware.Now();
 
     // Initialise WallFollower as default algorithm
     SetAlgorithm("WallFollower2");
     // SetAlgorithm("FloodFill");
 
     // Make Jonathan happy and let the IR run a few cycles c:
-    fiber_sleep(80);
+    hardware.Sleep(80);
 }
 
-void Mouse2::Run(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
+void Mouse2::Run(HAL::Timestamp now, HAL::Timestamp dt)
 {
-#ifdef MOCK
-    // Mock sensors
-    MockSensors();
-#endif
+    PROFILE(MouseRun);
 
     // Run IR sensors
-    fiber_sleep(0);
+    hardware.Sleep(0);
+    hardware.Poll();
 
     // Step the algorithm if requested
     if (((now > next_algorithm_step_ms && state != State::Stopped) ||
-         (state == State::MoveStraight && GetDistance(Core::Direction::Forward) < 3.5f)) &&
+         (state == State::MoveStraight && PredictForward(now) < 3.5f)) &&
         IsMoving())
     {
         // Avoid stepping again until another tile change
-        next_algorithm_step_ms = std::numeric_limits<CODAL_TIMESTAMP>::max();
+        next_algorithm_step_ms = std::numeric_limits<HAL::Timestamp>::max();
         // Step the algorithm with current sensor data
         StepAlgorithm(now);
-
-#ifdef MOCK
-        // Just force move for mocking
-        if (state != State::Stopped)
-            MovedTile(GetGlobalForward());
-#endif
     }
 
     // FSM for movement states
@@ -77,18 +55,18 @@ void Mouse2::Run(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
         MoveTurn(now, 60);
         break;
     case State::Stopped:
-        driver->StopMotors();
+        hardware.StopMotors();
         break;
     case State::StepFail:
-        driver->StopMotors();
+        hardware.StopMotors();
 
         // Let the ultrasonic cycle
-        if (now - last_step > 120)
+        if (now - last_step > hardware.GetSensorCycle())
             StepAlgorithm(now);
 
         break;
     default:
-        driver->StopMotors();
+        hardware.StopMotors();
         LOG_ERROR("INVALID STATE");
         break;
     }
@@ -96,21 +74,23 @@ void Mouse2::Run(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
     // fiber_sleep(10);
 }
 
-void Mouse2::Initialize(CODAL_TIMESTAMP now)
+void Mouse2::Initialize(HAL::Timestamp now)
 {
     // Ensure all the ultrasonic sensors has been initialized
-    fiber_sleep(sensor_count * measurement_interval_ms);
+    hardware.Sleep(hardware.GetSensorCycle());
+    hardware.Poll();
 
     // Assume that if back distance is longer than front that the robot was placed with reverse
     // front
-    reverse_forward = b > f;
+    reverse_forward =
+        hardware.GetDistance(HAL::Sensor::Back) > hardware.GetDistance(HAL::Sensor::Front);
 
     StepAlgorithm(now);
 
     next_expected_tiley_ms = now + 250; // Assume next tiley is at least 100ms later after start
 }
 
-void Mouse2::MoveStraight(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
+void Mouse2::MoveStraight(HAL::Timestamp now, HAL::Timestamp dt)
 {
     float left{GetDistance(Core::Direction::Left)};
     float right{GetDistance(Core::Direction::Right)};
@@ -134,8 +114,6 @@ void Mouse2::MoveStraight(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
 
     // Detect tile changes by seeing a difference in IR values
     auto summ{sum_sides_avg.AddValueAndMean(left + right)};
-    static auto last_summ{summ};
-    static int itty{0};
     if (summ > (last_summ + 0.150f) && (now > next_expected_tiley_ms))
     {
         ++itty;
@@ -163,14 +141,14 @@ void Mouse2::MoveStraight(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
     SetMotors(forward_pwm, right_pwm, rot_pwm);
 }
 
-void Mouse2::MoveTurn(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
+void Mouse2::MoveTurn(HAL::Timestamp now, HAL::Timestamp dt)
 {
     float left{GetDistance(Core::Direction::Left)};
     float right{GetDistance(Core::Direction::Right)};
 
     float turning{move_direction == Core::Direction::Left ? -1.0f : 1.0f};
 
-    CODAL_TIMESTAMP turn_time{now - turn_started};
+    HAL::Timestamp turn_time{now - turn_started};
 
     if ((turn_time > 900 &&
          (GetDistance(Core::Direction::Forward) < 12.0f || left < 4.9f || right < 4.9f)) ||
@@ -197,8 +175,10 @@ void Mouse2::MoveTurn(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt)
     }
 }
 
-void Mouse2::StepAlgorithm(CODAL_TIMESTAMP now)
+void Mouse2::StepAlgorithm(HAL::Timestamp now)
 {
+    PROFILE(StepAlgorithm);
+
     last_step = now;
     // Get distances to sides
     float front{GetDistance(Core::Direction::Forward)};
@@ -211,7 +191,8 @@ void Mouse2::StepAlgorithm(CODAL_TIMESTAMP now)
     auto global_right{global_forward.TurnRight()};
     auto global_backward{global_forward.TurnRight(2)};
 
-    float last_front{reverse_forward ? last_b : last_f};
+    float last_front{
+        hardware.GetLastDistance(reverse_forward ? HAL::Sensor::Back : HAL::Sensor::Front)};
 
     // Sense walls
     if (front < 16.5f && last_front < 18.5f)
@@ -229,6 +210,17 @@ void Mouse2::StepAlgorithm(CODAL_TIMESTAMP now)
     else
         GetMaze()->GetTile(x, y) &= ~global_right.TileSide();
 
+    // The outer walls are always there, a missed reading must not let the algorithm leave the maze
+    auto &tile{GetMaze()->GetTile(x, y)};
+    if (x <= 0.0f)
+        tile |= Core::MazeTile::Left;
+    if (x >= GetMaze()->GetWidth() - 1)
+        tile |= Core::MazeTile::Right;
+    if (y <= 0.0f)
+        tile |= Core::MazeTile::Down;
+    if (y >= GetMaze()->GetHeight() - 1)
+        tile |= Core::MazeTile::Up;
+
     LOG_DEBUG("Stepping algorithm, current forward(global): {}, x:{} y:{} rot:{}",
               global_forward.ToString(), static_cast<int>(x), static_cast<int>(y),
               static_cast<int>(rot));
@@ -282,10 +274,6 @@ void Mouse2::StepAlgorithm(CODAL_TIMESTAMP now)
 
     rot = dir.Degrees();
     iter++;
-
-#ifdef MOCK
-    next_algorithm_step_ms = now + 500; // Force next step in 500ms
-#endif
 }
 
 float Mouse2::GetDistance(Core::Direction direction)
@@ -293,18 +281,47 @@ float Mouse2::GetDistance(Core::Direction direction)
     switch (direction.Value())
     {
     case Core::Direction::Forward:
-        return reverse_forward ? b : f;
+        return hardware.GetDistance(reverse_forward ? HAL::Sensor::Back : HAL::Sensor::Front);
     case Core::Direction::Backward:
-        return reverse_forward ? f : b;
+        return hardware.GetDistance(reverse_forward ? HAL::Sensor::Front : HAL::Sensor::Back);
     case Core::Direction::Left:
-        return reverse_forward ? r : l;
+        return hardware.GetDistance(reverse_forward ? HAL::Sensor::Right : HAL::Sensor::Left);
     case Core::Direction::Right:
-        return reverse_forward ? l : r;
+        return hardware.GetDistance(reverse_forward ? HAL::Sensor::Left : HAL::Sensor::Right);
     default:
         return 0;
     };
 }
 
+float Mouse2::PredictForward(HAL::Timestamp now)
+{
+    auto sensor{reverse_forward ? HAL::Sensor::Back : HAL::Sensor::Front};
+    auto latest{hardware.GetSample(sensor)};
+
+    // 0 is out of range, so there is no rate to carry on
+    if (latest.distance <= 0.0f)
+        return latest.distance;
+
+    // Take the median of the rates between consecutive samples, so a single bad echo is ignored
+    Filters::MedianFilter<float, HAL::Hardware::HISTORY - 1> rates;
+    for (size_t age{1}; age < hardware.GetSampleCount(sensor); age++)
+    {
+        auto newer{hardware.GetSample(sensor, age - 1)};
+        auto older{hardware.GetSample(sensor, age)};
+        if (older.distance <= 0.0f || newer.time <= older.time)
+            break;
+        rates.AddValue((newer.distance - older.distance) / (newer.time - older.time));
+    }
+    if (rates.Size() < 2)
+        return latest.distance;
+
+    // Never closing in faster than the mouse can drive, nor for longer than a sensor cycle
+    float rate{std::clamp(rates.Median(), -MAX_CLOSING_RATE, MAX_CLOSING_RATE)};
+    HAL::Timestamp age{now > latest.time ? now - latest.time : 0};
+    age = std::min<HAL::Timestamp>(age, hardware.GetSensorCycle());
+    return latest.distance + (rate * age);
+}
+
 Core::Direction Mouse2::GetGlobalForward() { return Core::Direction::FromRot(rot); }
 
 void Mouse2::Step()
@@ -313,20 +330,8 @@ void Mouse2::Step()
     if (IsMoving())
         return;
 
-#ifdef MOCK
-    // Mock sensors
-    MockSensors();
-#endif
-
     // Step manually
-    StepAlgorithm(uBit.timer.getTime());
-
-#ifdef MOCK
-    // Just force move for mocking
-    if (state != State::Stopped)
-        MovedTile(GetGlobalForward());
-    state = State::Stopped;
-#endif
+    StepAlgorithm(hardware.Now());
 }
 
 void Mouse2::Reset()
@@ -345,6 +350,8 @@ void Mouse2::Reset()
     state = State::Uninitialized;
     iter = 0; // Reset maze for MouseService
     turn_iter = -1;
+    last_summ = std::numeric_limits<float>::max();
+    itty = 0;
 }
 
 void Mouse2::SetMotors(float forward, float right, float rot)
@@ -358,7 +365,7 @@ void Mouse2::SetMotors(float forward, float right, float rot)
         right *= -1;
     }
 
-    driver->SetMotors(static_cast<int16_t>((forward - right + rot) / denominator * 4095.0f),
+    hardware.SetMotors(static_cast<int16_t>((forward - right + rot) / denominator * 4095.0f),
                       static_cast<int16_t>((forward + right + rot) / denominator * 4095.0f),
                       static_cast<int16_t>((forward + right - rot) / denominator * 4095.0f),
                       static_cast<int16_t>((forward - right - rot) / denominator * 4095.0f));
@@ -388,47 +395,4 @@ void Mouse2::MovedTile(Core::Direction direction)
 
 void Mouse2::CalibrateForward() { last_forward_heading = heading_avg.MeanDegrees(); }
 
-#ifdef MOCK
-
-float &Mouse2::GetDistanceAlias(Core::Direction direction)
-{
-    switch (direction.Value())
-    {
-    case Core::Direction::Forward:
-        return reverse_forward ? b : f;
-    case Core::Direction::Backward:
-        return reverse_forward ? f : b;
-    case Core::Direction::Left:
-        return reverse_forward ? r : l;
-    case Core::Direction::Right:
-        return reverse_forward ? l : r;
-    };
-}
-
-void Mouse2::MockSensors()
-{
-    if (y > 4.9f && x < 1.0f)
-    {
-        GetDistanceAlias(Core::Direction::Forward) = 8.0f;
-        GetDistanceAlias(Core::Direction::Right) = 6.1f;
-        GetDistanceAlias(Core::Direction::Left) = 4.1f;
-    }
-    else if (std::abs(y - 5) < 0.1f && x > 7.9f)
-    {
-        GetDistanceAlias(Core::Direction::Forward) = 8.0f;
-        GetDistanceAlias(Core::Direction::Right) = 4.1f;
-        GetDistanceAlias(Core::Direction::Left) = 6.1f;
-    }
-    else
-    {
-        GetDistanceAlias(Core::Direction::Forward) = 21.0f;
-        GetDistanceAlias(Core::Direction::Right) = 4.1f;
-        GetDistanceAlias(Core::Direction::Left) = 4.1f;
-    }
-
-    GetDistanceAlias(Core::Direction::Backward) = 4.0f;
-}
-
-#endif
-
 } // namespace Firmware
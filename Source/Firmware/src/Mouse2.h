@@ -1,22 +1,22 @@
 #pragma once
-#include <MicroBit.h>
 
 #include <Core/Mouse.h>
 
 #include <math.h>
 
-#include <deque>
+#include <limits>
 
-#include "Drivers/DFR0548.h"
-#include "Drivers/HCSR04.h"
-#include "Drivers/IR.h"
+#include "Filters.h"
+#include "HAL/Hardware.h"
 #include "PID.h"
-#include "Utils.h"
 
 namespace Firmware
 {
 
 /*! \brief MicroMouse related main loop, state machine with senseing and acting
+ *
+ *  All hardware is accessed through HAL::Hardware, so the same state machine runs on the micro:bit
+ * with HAL::CodalHardware and on desktop with HAL::HostHardware.
  */
 class Mouse2 : public Core::Mouse
 {
@@ -30,9 +30,9 @@ public:
         StepFail
     };
 
-    Mouse2(MicroBit &uBit, Drivers::DFR0548 *driver);
+    Mouse2(HAL::Hardware &hardware);
     //! Run regulation for movement, ran until movement is done
-    void Run(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt);
+    void Run(HAL::Timestamp now, HAL::Timestamp dt);
 
     //! \brief Start a single step
     //!
@@ -53,7 +53,7 @@ public:
     {
         this->running = running;
         if (running && (state == State::Stopped || state == State::StepFail))
-            StepAlgorithm(uBit.timer.getTime());
+            StepAlgorithm(hardware.Now());
     }
     //! Return if the mouse is currently finishing a move/step
     inline bool IsMoving() noexcept
@@ -64,76 +64,68 @@ public:
     inline void SetResetAlgorithm(uint16_t index) noexcept { algorithm = index; }
     //! Get the step iter count
     inline int GetIter() noexcept { return iter; }
+    //! Get the state of the movement state machine
+    inline State GetState() noexcept { return state; }
 
 private:
     //! External class objects
-    MicroBit &uBit;
-    Drivers::DFR0548 *driver;
-    std::unique_ptr<Drivers::HCSR04> ultrasonics;
-    std::unique_ptr<Drivers::IR> IRs;
-    int sensor_count;
-    uint64_t prev_time_ms; // Value of last time reading
+    HAL::Hardware &hardware;
+    uint64_t prev_time_ms{0}; // Value of last time reading
     State state{State::Uninitialized};
     Core::Direction move_direction{Core::Direction::Forward}; // Move direction (local)
-    CODAL_TIMESTAMP next_expected_tiley_ms;
-    CODAL_TIMESTAMP next_algorithm_step_ms{std::numeric_limits<CODAL_TIMESTAMP>::max()};
-    CODAL_TIMESTAMP turn_started{0};
-    CODAL_TIMESTAMP turn_ended{0};
-    CODAL_TIMESTAMP stop_until{0};
-    CODAL_TIMESTAMP last_step{0};
+    HAL::Timestamp next_expected_tiley_ms{0};
+    HAL::Timestamp next_algorithm_step_ms{std::numeric_limits<HAL::Timestamp>::max()};
+    HAL::Timestamp turn_started{0};
+    HAL::Timestamp turn_ended{0};
+    HAL::Timestamp stop_until{0};
+    HAL::Timestamp last_step{0};
 
-    bool reverse_forward;
-    int last_forward_heading; // Heading to last forward
+    bool reverse_forward{false};
+    int last_forward_heading{0}; // Heading to last forward
 
     // Filtering-related variables
-    Filters::MovingAverageFilter<int, 64> heading_avg;
+    Filters::CircularMeanFilter<64> heading_avg;
     Filters::MovingAverageFilter<float, 3> sum_sides_avg;
+    //! Last mean of the side distances, used to detect tile changes
+    float last_summ{std::numeric_limits<float>::max()};
+    //! Amount of tile changes detected
+    int itty{0};
 
     //! True if the Mouse2 is running autonomously, set false for manual control
     bool running{false};
     //! Set the algorithm to use on reset, > 0
     int16_t algorithm{-1};
 
-    //! Distance measurements to front, left and right obstructions
-    std::atomic<float> f{0.0f};
-    std::atomic<float> b{0.0f};
-    std::atomic<float> last_f{0.0f};
-    std::atomic<float> last_b{0.0f};
-    std::atomic<float> l{0.0f};
-    std::atomic<float> r{0.0f};
     const float LENGTH_OF_MOUSE = 16;
+    //! Fastest plausible change of a forward distance, in cm/ms
+    static constexpr float MAX_CLOSING_RATE{0.05f};
 
     int iter = 0;
     int turn_iter{-1};
     bool turn_pid{false};
 
-    uint16_t measurement_interval_ms;
-
     float forward_pwm = 0.0f;
     float right_pwm = 0.0f;
     float rot_pwm = 0.0f;
 
     PID right_pid;
 
-    void Initialize(CODAL_TIMESTAMP now);
-    void MoveStraight(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt);
-    void MoveTurn(CODAL_TIMESTAMP now, CODAL_TIMESTAMP dt);
+    void Initialize(HAL::Timestamp now);
+    void MoveStraight(HAL::Timestamp now, HAL::Timestamp dt);
+    void MoveTurn(HAL::Timestamp now, HAL::Timestamp dt);
     //! Read the walls and step algorithm
-    void StepAlgorithm(CODAL_TIMESTAMP now);
+    void StepAlgorithm(HAL::Timestamp now);
     //! Called with global direction of a move
     void MovedTile(Core::Direction moved_tile);
+    //! Get the forward distance at \p now, extrapolated at the median rate of the sample history
+    //! to make up for the age of the latest, over at most one sensor cycle
+    float PredictForward(HAL::Timestamp now);
     //! Get global forward that is compensated for reverse forward
     Core::Direction GetGlobalForward();
 
     void SetMotors(float forward, float right, float rot);
     //! Calibrate the forward heading
     void CalibrateForward();
-
-#ifdef MOCK
-    float &GetDistanceAlias(Core::Direction direction);
-    //! Mock sensors
-    void MockSensors();
-#endif
 };
 
 } // namespace Firmware
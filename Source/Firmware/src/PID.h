@@ -1,4 +1,7 @@
-#include <Timer.h>
+#pragma once
+
+#include <cstdint>
+#include <string>
 
 namespace Firmware
 {
@@ -36,13 +36,13 @@ void Timer::EveryUs(CODAL_TIMESTAMP interval)
 void Timer::AfterMs(CODAL_TIMESTAMP period)
 {
     Reset();
-    system_timer_event_after(interval, MICROBIT_ID_MICROBROS_TIMER, id);
+    system_timer_event_after(period, MICROBIT_ID_MICROBROS_TIMER, id);
 }
 
 void Timer::AfterUs(CODAL_TIMESTAMP period)
 {
     Reset();
-    system_timer_event_after_us(interval, MICROBIT_ID_MICROBROS_TIMER, id);
+    system_timer_event_after_us(period, MICROBIT_ID_MICROBROS_TIMER, id);
 }
 
 //! Reset the timer
@@ -2,29 +2,32 @@
 #include <memory>
 
 #include <Core/Log.h>
+#include <Core/Profiler.h>
 
 #ifdef DEVICE_BLE
 #include "BLE/MotorService.h"
 #include "BLE/MouseService.h"
 #endif
 #include "Drivers/DFR0548.h"
+#include "HAL/Codal.h"
 #include "Mouse2.h"
 
-// TEMP
-#include "Drivers/HCSR04.h"
-#include "Drivers/IR.h"
 MicroBit uBit;
 
 int main()
 {
     uBit.init();
 
+    // Start the cycle counter used by the PROFILE probes
+    Core::Profiler::Init();
+
     // Create the DFR0548 motor driver
     auto dfr0548{std::make_unique<Firmware::Drivers::DFR0548>(uBit, uBit.i2c, false)};
     // Firmware::Mouse mouse(uBit, dfr0548);
 
-    // Create mouse impl
-    auto mouse{std::make_unique<Firmware::Mouse2>(uBit, dfr0548.get())};
+    // Create the hardware with the sensors and the mouse impl
+    auto hardware{std::make_unique<Firmware::HAL::CodalHardware>(uBit, dfr0548.get())};
+    auto mouse{std::make_unique<Firmware::Mouse2>(*hardware)};
 
 // Setup BLE services
 // auto motor_service{std::make_unique<Firmware::BLE::MotorService>(dfr0548.get())};
@@ -53,6 +56,10 @@ int main()
 #ifdef DEVICE_BLE
         mouse_service->Update();
 #endif
+
+        // Write the deferred log records to serial
+        Core::Logger::Flush();
+
         // Simple toggle of running by pressing A
         if (!last_pressed_a && uBit.buttonA.isPressed())
         {
@@ -0,0 +1,289 @@
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include <Core/Log.h>
+
+#include "Decoder.h"
+
+namespace LogDecoder
+{
+
+using Core::LogRecord::ArgType;
+
+// Unescape the contents of a C++ string literal
+static std::string Unescape(std::string_view literal)
+{
+    std::string text;
+    for (size_t i{0}; i < literal.size(); ++i)
+    {
+        if (literal[i] != '\\' || i + 1 == literal.size())
+        {
+            text += literal[i];
+            continue;
+        }
+
+        char c{literal[++i]};
+        switch (c)
+        {
+        case 'n':
+            text += '\n';
+            break;
+        case 't':
+            text += '\t';
+            break;
+        case 'r':
+            text += '\r';
+            break;
+        case '0':
+            text += '\0';
+            break;
+        case 'x':
+        {
+            size_t length{0};
+            while (length < 2 && i + 1 + length < literal.size() &&
+                   std::isxdigit(static_cast<unsigned char>(literal[i + 1 + length])))
+                length++;
+            std::string digits{literal.substr(i + 1, length)};
+            text += static_cast<char>(std::stoi(digits, 0, 16));
+            i += length;
+            break;
+        }
+        default:
+            text += c;
+            break;
+        }
+    }
+
+    return text;
+}
+
+Decoder::Decoder()
+{
+    // Used by Core::Logger::Log for pre-formatted text
+    AddFormat("{}");
+}
+
+size_t Decoder::ScanSources(const std::filesystem::path &path)
+{
+    // The string literals directly after the opening of a LOG macro, or after the level of
+    // LOG_LEVEL
+    static const std::regex macro{R"(\bLOG(?:(?:_ERROR|_WARN|_INFO|_DEBUG)?\s*\()"
+                                  R"(|_LEVEL\s*\([^,"]*,))"
+                                  R"(\s*((?:"(?:[^"\\]|\\.)*"\s*)+))"};
+    static const std::regex literal{R"re("((?:[^"\\]|\\.)*)")re"};
+
+    if (!std::filesystem::is_directory(path))
+        throw std::runtime_error(fmt::format("{} is not a directory", path.string()));
+
+    size_t count{0};
+    for (auto &entry : std::filesystem::recursive_directory_iterator(path))
+    {
+        auto extension{entry.path().extension()};
+        if (!entry.is_regular_file() || (extension != ".h" && extension != ".cpp"))
+            continue;
+
+        std::ifstream file{entry.path()};
+        std::stringstream stream;
+        stream << file.rdbuf();
+        std::string source{stream.str()};
+
+        for (auto it{std::sregex_iterator(source.begin(), source.end(), macro)};
+             it != std::sregex_iterator(); ++it)
+        {
+            // Adjacent literals are concatenated
+            std::string literals{(*it)[1]};
+            std::string format;
+            for (auto part{std::sregex_iterator(literals.begin(), literals.end(), literal)};
+                 part != std::sregex_iterator(); ++part)
+                format += Unescape((*part)[1].str());
+
+            AddFormat(format);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void Decoder::AddFormat(std::string format)
+{
+    uint32_t id{Core::LogRecord::FormatId(format)};
+
+    auto it{formats.find(id)};
+    if (it != formats.end() && it->second != format)
+        LOG_WARN("Format id {:08x} of \"{}\" collides with \"{}\"", id, format, it->second);
+
+    formats[id] = std::move(format);
+}
+
+void Decoder::Feed(std::span<const uint8_t> data,
+                   const std::function<void(std::string_view)> &output)
+{
+    pending.insert(pending.end(), data.begin(), data.end());
+
+    size_t offset{0};
+    while (offset < pending.size())
+    {
+        // Find the start of the next record
+        if (pending[offset] != Core::LogRecord::SYNC)
+        {
+            offset++;
+            skipped++;
+            continue;
+        }
+
+        // Wait for the rest of the record
+        if (pending.size() - offset < Core::LogRecord::HEADER_SIZE)
+            break;
+        size_t payload_size{pending[offset + 1]};
+        if (pending.size() - offset < Core::LogRecord::HEADER_SIZE + payload_size)
+            break;
+
+        // Move the record to the start
+        pending.erase(pending.begin(), pending.begin() + offset);
+        offset = 0;
+
+        if (Render(payload_size, output))
+            offset = Core::LogRecord::HEADER_SIZE + payload_size;
+        else
+        {
+            offset = 1;
+            skipped++;
+        }
+    }
+
+    pending.erase(pending.begin(), pending.begin() + std::min(offset, pending.size()));
+}
+
+bool Decoder::Render(size_t payload_size, const std::function<void(std::string_view)> &output)
+{
+    uint8_t flags{pending[2]};
+    uint32_t id;
+    uint32_t time;
+    std::memcpy(&id, &pending[3], sizeof(id));
+    std::memcpy(&time, &pending[7], sizeof(time));
+
+    auto level{static_cast<Core::Logger::LogLevel>(flags & ~Core::LogRecord::NEWLINE)};
+    if (level > Core::Logger::LogLevel::Debug)
+        return false;
+
+    // Decode the arguments, they have to fill the payload exactly
+    fmt::dynamic_format_arg_store<fmt::format_context> args;
+    size_t argc{0};
+
+    const uint8_t *in{&pending[Core::LogRecord::HEADER_SIZE]};
+    const uint8_t *end{in + payload_size};
+    auto read{[&in, end](void *value, size_t size)
+              {
+                  if (static_cast<size_t>(end - in) < size)
+                      return false;
+                  std::memcpy(value, in, size);
+                  in += size;
+                  return true;
+              }};
+
+    while (in < end)
+    {
+        auto type{static_cast<ArgType>(*in++)};
+        argc++;
+
+#define READ_ARG(TYPE)                                                                             \
+    {                                                                                              \
+        TYPE value;                                                                                \
+        if (!read(&value, sizeof(value)))                                                          \
+            return false;                                                                          \
+        args.push_back(value);                                                                     \
+    }
+        switch (type)
+        {
+        case ArgType::Bool:
+        {
+            uint8_t value;
+            if (!read(&value, 1) || value > 1)
+                return false;
+            args.push_back(value == 1);
+            break;
+        }
+        case ArgType::Int32:
+            READ_ARG(int32_t)
+            break;
+        case ArgType::UInt32:
+            READ_ARG(uint32_t)
+            break;
+        case ArgType::Int64:
+            READ_ARG(int64_t)
+            break;
+        case ArgType::UInt64:
+            READ_ARG(uint64_t)
+            break;
+        case ArgType::Float:
+            READ_ARG(float)
+            break;
+        case ArgType::Double:
+            READ_ARG(double)
+            break;
+        case ArgType::String:
+        {
+            uint8_t length;
+            if (!read(&length, 1) || length > Core::LogRecord::MAX_STRING ||
+                static_cast<size_t>(end - in) < length)
+                return false;
+            args.push_back(std::string{reinterpret_cast<const char *>(in), length});
+            in += length;
+            break;
+        }
+        default:
+            return false;
+        }
+#undef READ_ARG
+    }
+
+    // Render the text
+    std::string text;
+    if (id == Core::LogRecord::DROPPED_ID)
+    {
+        if (argc != 1)
+            return false;
+        text = fmt::vformat("{} log records dropped", args);
+    }
+    else if (auto format{formats.find(id)}; format != formats.end())
+    {
+        try
+        {
+            text = fmt::vformat(format->second, args);
+        }
+        catch (const fmt::format_error &e)
+        {
+            text = fmt::format("{} <{} arguments do not match: {}>", format->second, argc,
+                               e.what());
+        }
+    }
+    else
+        text = fmt::format("<unknown format {:08x} with {} arguments>", id, argc);
+
+    // Prefix the start of every line with the time and level
+    std::string line;
+    if (line_start)
+    {
+        line = fmt::format("[{:>4}.{:03}] ", time / 1000, time % 1000);
+        if (level != Core::Logger::LogLevel::None)
+            line += fmt::format("{} ", Core::GetLogLevelString(level));
+    }
+    line += text;
+
+    line_start = (flags & Core::LogRecord::NEWLINE) != 0 || (!text.empty() && text.back() == '\n');
+    if ((flags & Core::LogRecord::NEWLINE) != 0)
+        line += '\n';
+
+    output(line);
+    return true;
+}
+
+} // namespace LogDecoder
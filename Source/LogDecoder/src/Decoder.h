@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace LogDecoder
+{
+
+/*! \brief Renders the deferred Core::LogRecord stream written by the Firmware
+ *
+ *  The firmware only sends the Core::LogRecord::FormatId of every format string, so the format
+ * strings are found again by scanning the LOG macros in the sources. The stream may start or be cut
+ * in the middle of a record, the Decoder skips bytes until the next valid record.
+ */
+class Decoder
+{
+public:
+    Decoder();
+
+    //! Add the format strings of every LOG macro in the *.h and *.cpp files under \p path, returns
+    //! the count of format strings found
+    size_t ScanSources(const std::filesystem::path &path);
+    //! Add a single \p format string
+    void AddFormat(std::string format);
+
+    //! Decode \p data, calling \p output with the rendered text, keeps incomplete records for the
+    //! next call
+    void Feed(std::span<const uint8_t> data, const std::function<void(std::string_view)> &output);
+
+    //! Get the count of bytes skipped while searching for a valid record
+    inline size_t GetSkipped() const noexcept { return skipped; }
+
+private:
+    std::unordered_map<uint32_t, std::string> formats;
+    std::vector<uint8_t> pending;
+    size_t skipped{0};
+    bool line_start{true};
+
+    //! Render the record at the start of pending, returns false if it is not a valid record
+    bool Render(size_t payload_size, const std::function<void(std::string_view)> &output);
+};
+
+} // namespace LogDecoder
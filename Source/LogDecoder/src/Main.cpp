@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Decoder.h"
+
+void PrintUsage(const std::string &program)
+{
+    fmt::println("Usage: {} <source directory> [capture]", program);
+    fmt::println("  Renders the deferred log records of the Firmware read from the capture, or");
+    fmt::println("  from stdin if omitted, using the format strings found in the source directory");
+}
+
+int main(int argc, char *argv[])
+{
+    // Read the args from argv
+    std::vector<std::string> args{argv, argv + argc};
+
+    if (args.size() < 2 || args.size() > 3)
+    {
+        PrintUsage(args[0]);
+        return 1;
+    }
+
+    auto print{[](std::string_view text)
+               {
+                   fmt::print("{}", text);
+                   std::fflush(stdout);
+               }};
+
+    try
+    {
+        LogDecoder::Decoder decoder;
+        if (decoder.ScanSources(args[1]) == 0)
+            std::cerr << "No log format strings found in " << args[1] << std::endl;
+
+        if (args.size() == 3)
+        {
+            std::ifstream file{args[2], std::ios::binary};
+            if (!file)
+                throw std::runtime_error(fmt::format("Unable to open {}", args[2]));
+
+            std::vector<uint8_t> data{std::istreambuf_iterator<char>(file),
+                                      std::istreambuf_iterator<char>()};
+            decoder.Feed(data, print);
+        }
+        // Decode as the bytes arrive, e.g. piped from the serial port
+        else
+        {
+            int c;
+            while ((c = std::getchar()) != EOF)
+            {
+                uint8_t byte{static_cast<uint8_t>(c)};
+                decoder.Feed({&byte, 1}, print);
+            }
+        }
+
+        if (decoder.GetSkipped() > 0)
+            std::cerr << "Skipped " << decoder.GetSkipped() << " bytes of invalid records"
+                      << std::endl;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <Core/Log.h>
+#include <Core/RunTrace.h>
+
+#include "Runner.h"
+
+void PrintUsage(const std::string &program)
+{
+    fmt::println("Usage: {} <maze directory or archive> [options]", program);
+    fmt::println("       {} --diff <trace> <trace>", program);
+    fmt::println("  --steps <n>        Maximum steps per run (default 100000)");
+    fmt::println("  --threads <n>      Worker threads, 0 uses every hardware thread (default 0)");
+    fmt::println("  --algorithm <name> Only run the algorithm, can be repeated");
+    fmt::println("  --summary          Only print the summary");
+    fmt::println("  --pack <archive>   Pack the mazes into an archive without duplicates and exit");
+    fmt::println("  --trace <dir>      Save a trace of every run into the directory");
+    fmt::println("  --firmware         Run the firmware control loop against a physics model");
+    fmt::println("  --help             Print this help");
+}
+
+// Print the first step where two traces differ
+int DiffTraces(const std::string &a_path, const std::string &b_path)
+{
+    auto a{Core::RunTrace::Load(a_path)};
+    auto b{Core::RunTrace::Load(b_path)};
+
+    auto step{Core::RunTrace::FirstDifference(a, b)};
+    if (!step)
+    {
+        fmt::println("Traces are identical for {} steps", a.Size());
+        return 0;
+    }
+
+    fmt::println("Traces differ at step {} ({} and {} steps)", *step, a.Size(), b.Size());
+    for (auto [path, trace] : {std::pair{&a_path, &a}, std::pair{&b_path, &b}})
+    {
+        if (*step >= trace->Size())
+        {
+            fmt::println("  {}: ended", *path);
+            continue;
+        }
+
+        auto record{trace->Get(*step)};
+        // A single step that moved is not an unfinished run
+        std::string_view result{record.result == Core::Simulation::StepResult::Moved
+                                    ? "Moved"
+                                    : Core::Simulation::GetStepResultString(record.result)};
+        fmt::println("  {}: at {},{} facing {}, moving {}, {}", *path, record.x, record.y,
+                     record.heading.ToString(),
+                     record.direction ? record.direction->ToString() : "none", result);
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    // Read the args from argv
+    std::vector<std::string> args{argv, argv + argc};
+
+    if (args.size() < 2)
+    {
+        PrintUsage(args[0]);
+        return 1;
+    }
+
+    if (args[1] == "--help" || args[1] == "-h")
+    {
+        PrintUsage(args[0]);
+        return 0;
+    }
+
+    if (args[1] == "--diff")
+    {
+        if (args.size() != 4)
+        {
+            PrintUsage(args[0]);
+            return 1;
+        }
+
+        try
+        {
+            return DiffTraces(args[2], args[3]);
+        }
+        catch (std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Any other flag in place of the maze path is unknown
+    if (args[1].starts_with("-"))
+    {
+        std::cerr << "Unknown option " << args[1] << std::endl;
+        PrintUsage(args[0]);
+        return 1;
+    }
+
+    uint64_t max_steps{100'000};
+    size_t threads{0};
+    bool summary_only{false};
+    std::string pack_path;
+    std::string trace_path;
+    bool firmware{false};
+    std::vector<std::string> algorithms;
+
+    try
+    {
+        for (size_t i{2}; i < args.size(); ++i)
+        {
+            if (args[i] == "--steps" && i + 1 < args.size())
+                max_steps = std::stoull(args[++i]);
+            else if (args[i] == "--threads" && i + 1 < args.size())
+                threads = std::stoul(args[++i]);
+            else if (args[i] == "--algorithm" && i + 1 < args.size())
+                algorithms.push_back(args[++i]);
+            else if (args[i] == "--summary")
+                summary_only = true;
+            else if (args[i] == "--pack" && i + 1 < args.size())
+                pack_path = args[++i];
+            else if (args[i] == "--trace" && i + 1 < args.size())
+                trace_path = args[++i];
+            else if (args[i] == "--firmware")
+                firmware = true;
+            else if (args[i] == "--help" || args[i] == "-h")
+            {
+                PrintUsage(args[0]);
+                return 0;
+            }
+            else
+            {
+                std::cerr << "Unknown option " << args[i] << std::endl;
+                PrintUsage(args[0]);
+                return 1;
+            }
+        }
+
+        Runner::MazeRunner runner{max_steps};
+        if (!algorithms.empty())
+            runner.SetAlgorithms(algorithms);
+
+        runner.LoadMazes(args[1]);
+
+        if (!pack_path.empty())
+        {
+            fmt::println("Packed {} mazes into {}", runner.SaveArchive(pack_path), pack_path);
+            return 0;
+        }
+
+        // The firmware logs every step, only keep the warnings and errors
+        if (firmware)
+        {
+            runner.SetFirmware(true);
+            Core::Logger::SetLevel(Core::Logger::LogLevel::Warn);
+        }
+
+        if (!trace_path.empty())
+        {
+            std::filesystem::create_directories(trace_path);
+            runner.SetTraceDirectory(trace_path);
+        }
+
+        runner.RunAll(threads);
+
+        if (!summary_only)
+            runner.PrintRuns();
+        runner.PrintSummary();
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
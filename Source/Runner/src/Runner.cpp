@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <chrono>
+
+#include <fmt/format.h>
+
+#include <Core/Algorithm.h>
+#include <Core/Log.h>
+#include <Core/MazeArchive.h>
+#include <Core/MazeFile.h>
+#include <Core/RunTrace.h>
+#include <HAL/Physics.h>
+#include <Mouse2.h>
+
+#include "Runner.h"
+#include "ThreadPool.h"
+
+using namespace Core;
+
+namespace Runner
+{
+
+//! Interval in ms between runs of the firmware control loop
+static constexpr Firmware::HAL::Timestamp FIRMWARE_TICK{5};
+//! Virtual time in ms a firmware run may take, the length of a contest run
+static constexpr Firmware::HAL::Timestamp FIRMWARE_TIME_LIMIT{10 * 60 * 1000};
+//! Time in ms a firmware run may fail to step the algorithm before stopping
+static constexpr Firmware::HAL::Timestamp FIRMWARE_FAIL_LIMIT{1000};
+
+MazeRunner::MazeRunner(uint64_t max_steps) : max_steps{max_steps}
+{
+    for (auto const &entry : AlgorithmRegistry::GetRegistry())
+        algorithms.emplace_back(entry.name);
+}
+
+void MazeRunner::LoadMazes(const std::filesystem::path &path)
+{
+    // Every maze of an archive is already parsed to the binary format
+    if (std::filesystem::is_regular_file(path))
+    {
+        MazeArchive archive{path};
+        for (size_t i{0}; i < archive.Size(); ++i)
+        {
+            mazes.push_back(archive.Load(i));
+            maze_names.emplace_back(archive.GetName(i));
+        }
+        return;
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for (auto const &entry : std::filesystem::directory_iterator(path))
+    {
+        auto extension{entry.path().extension()};
+        if (entry.is_regular_file() &&
+            (extension == ".txt" || extension == MazeFile::BINARY_EXTENSION))
+            paths.push_back(entry.path());
+    }
+
+    // Keep the output stable between runs
+    std::sort(paths.begin(), paths.end());
+
+    for (auto const &maze_path : paths)
+    {
+        try
+        {
+            mazes.push_back(Simulation::OpenMaze(maze_path.string()));
+            maze_names.push_back(maze_path.filename().string());
+        }
+        catch (const std::exception &e)
+        {
+            LOG_WARN("Skipping maze {}: {}", maze_path.string(), e.what());
+        }
+    }
+}
+
+size_t MazeRunner::SaveArchive(const std::filesystem::path &path)
+{
+    MazeArchive::Builder builder;
+    for (size_t i{0}; i < mazes.size(); ++i)
+    {
+        if (!builder.Add(maze_names[i], *mazes[i]))
+            LOG_INFO("Skipping maze {}: duplicate of an earlier maze", maze_names[i]);
+    }
+
+    builder.Save(path);
+    return builder.Size();
+}
+
+MazeRunner::Run MazeRunner::RunOne(size_t maze, size_t algorithm)
+{
+    Run run{.maze = maze,
+            .algorithm = algorithm,
+            .result = {},
+            .step_ns = 0,
+            .speed_run_time = std::nullopt,
+            .error = {}};
+
+    try
+    {
+        // Own copy of the Maze for this run, shared with no other worker
+        Simulation simulation{std::make_unique<Maze>(*mazes[maze])};
+        if (!simulation.Reset(algorithms[algorithm]))
+        {
+            run.error = "Unable to set algorithm";
+            return run;
+        }
+
+        std::optional<RunTrace> trace;
+        if (!trace_directory.empty())
+        {
+            trace.emplace(*simulation.GetMouse()->GetMaze());
+            simulation.SetTrace(&*trace);
+        }
+
+        auto start{std::chrono::steady_clock::now()};
+        run.result = simulation.Run(max_steps);
+        auto end{std::chrono::steady_clock::now()};
+
+        run.step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        if (trace)
+        {
+            // Keep the extension, so m7.txt and m7.maze do not overwrite each other's trace
+            auto name{std::filesystem::path(maze_names[maze]).filename().string()};
+            trace->Save(trace_directory /
+                        fmt::format("{}-{}{}", name, algorithms[algorithm], RunTrace::EXTENSION));
+        }
+
+        if (run.result.result == Simulation::StepResult::Finished)
+            run.speed_run_time = simulation.SpeedRunTime();
+    }
+    catch (const std::exception &e)
+    {
+        run.error = e.what();
+    }
+
+    return run;
+}
+
+MazeRunner::Run MazeRunner::RunFirmware(size_t maze, size_t algorithm)
+{
+    Run run{.maze = maze,
+            .algorithm = algorithm,
+            .result = {},
+            .step_ns = 0,
+            .speed_run_time = std::nullopt,
+            .error = {}};
+
+    try
+    {
+        Maze &true_maze{*mazes[maze]};
+        if (true_maze.GetWidth() != 16 || true_maze.GetHeight() != 16)
+        {
+            run.error = "Firmware only supports 16x16 mazes";
+            return run;
+        }
+
+        Firmware::HAL::PhysicsHardware hardware{true_maze};
+        Firmware::Mouse2 mouse{hardware};
+        if (!mouse.SetAlgorithm(algorithms[algorithm]))
+        {
+            run.error = "Unable to set algorithm";
+            return run;
+        }
+
+        std::vector<bool> visited(true_maze.GetWidth() * true_maze.GetHeight());
+        Firmware::HAL::Timestamp fail_since{0};
+
+        auto start{std::chrono::steady_clock::now()};
+        run.result.result = Simulation::StepResult::Moved;
+        mouse.SetRunning(true);
+        while (hardware.Now() < FIRMWARE_TIME_LIMIT &&
+               static_cast<uint64_t>(mouse.GetIter()) < max_steps)
+        {
+            hardware.Advance(FIRMWARE_TICK);
+            mouse.Run(hardware.Now(), FIRMWARE_TICK);
+
+            int x{hardware.TileX()};
+            int y{hardware.TileY()};
+            size_t tile{static_cast<size_t>((true_maze.GetWidth() * y) + x)};
+            if (!visited[tile])
+            {
+                visited[tile] = true;
+                run.result.explored++;
+            }
+
+            if (hardware.HasCollided())
+            {
+                run.result.result = Simulation::StepResult::Crashed;
+                break;
+            }
+            if (true_maze.GetTile(x, y).Contains(MazeTile::Goal))
+            {
+                run.result.result = Simulation::StepResult::Finished;
+                break;
+            }
+
+            // Give up if the algorithm keeps failing to step
+            if (mouse.GetState() != Firmware::Mouse2::State::StepFail)
+                fail_since = hardware.Now();
+            else if (hardware.Now() - fail_since > FIRMWARE_FAIL_LIMIT)
+            {
+                run.result.result = Simulation::StepResult::NoDirection;
+                break;
+            }
+        }
+        auto end{std::chrono::steady_clock::now()};
+
+        run.step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        run.result.steps = mouse.GetIter();
+        run.result.time = hardware.Now() / 1000.0;
+
+        // The position the Mouse believes it is in should match the true position
+        int mouse_x{static_cast<int>(mouse.X())};
+        int mouse_y{static_cast<int>(mouse.Y())};
+        if (mouse_x != hardware.TileX() || mouse_y != hardware.TileY())
+            run.error = fmt::format("Lost at {},{} believing {},{}", hardware.TileX(),
+                                    hardware.TileY(), mouse_x, mouse_y);
+    }
+    catch (const std::exception &e)
+    {
+        run.error = e.what();
+    }
+
+    return run;
+}
+
+void MazeRunner::RunAll(size_t threads)
+{
+    runs.clear();
+    runs.resize(mazes.size() * algorithms.size());
+
+    auto start{std::chrono::steady_clock::now()};
+    {
+        ThreadPool pool{threads};
+        threads_used = pool.Size();
+
+        // Every job writes only to its own slot in runs
+        for (size_t maze{0}; maze < mazes.size(); ++maze)
+        {
+            for (size_t algorithm{0}; algorithm < algorithms.size(); ++algorithm)
+            {
+                Run *run{&runs[(maze * algorithms.size()) + algorithm]};
+                pool.Submit(
+                    [this, run, maze, algorithm]()
+                    {
+                        *run = firmware ? RunFirmware(maze, algorithm) : RunOne(maze, algorithm);
+                    });
+            }
+        }
+
+        pool.Wait();
+    }
+    auto end{std::chrono::steady_clock::now()};
+
+    total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+void MazeRunner::PrintRuns()
+{
+    fmt::println("maze,algorithm,result,steps,explored,time,speed_run_time,ns_per_step,error");
+    for (auto &run : runs)
+    {
+        uint64_t ns_per_step{run.result.steps ? run.step_ns / run.result.steps : 0};
+        std::string speed_run_time{
+            run.speed_run_time ? fmt::format("{:.3f}", *run.speed_run_time) : ""};
+        fmt::println("{},{},{},{},{},{:.3f},{},{},{}", maze_names[run.maze],
+                     algorithms[run.algorithm], Simulation::GetStepResultString(run.result.result),
+                     run.result.steps, run.result.explored, run.result.time, speed_run_time,
+                     ns_per_step, run.error);
+    }
+}
+
+void MazeRunner::PrintSummary()
+{
+    std::vector<Summary> summaries(algorithms.size());
+    for (auto &run : runs)
+    {
+        auto &summary{summaries[run.algorithm]};
+        summary.runs++;
+        if (run.error.empty() && run.result.result == Simulation::StepResult::Finished)
+            summary.finished++;
+        summary.steps += run.result.steps;
+        summary.explored += run.result.explored;
+        summary.step_ns += run.step_ns;
+        summary.time += run.result.time;
+        if (run.speed_run_time)
+        {
+            summary.speed_runs++;
+            summary.speed_run_time += *run.speed_run_time;
+        }
+    }
+
+    fmt::println("Ran {} mazes x {} algorithms on {} threads in {:.3f} ms", mazes.size(),
+                 algorithms.size(), threads_used, total_ns / 1e6);
+    fmt::println("{:<20} {:>8} {:>10} {:>12} {:>12} {:>12} {:>12} {:>12}", "Algorithm", "Runs",
+                 "Finished", "Avg steps", "Avg explored", "Avg time", "Avg speedrun", "ns/step");
+    for (size_t i{0}; i < algorithms.size(); ++i)
+    {
+        auto &summary{summaries[i]};
+        double runs{static_cast<double>(std::max(summary.runs, size_t(1)))};
+        // No speed runs is not a time of 0
+        std::string speed_run_time{
+            summary.speed_runs
+                ? fmt::format("{:.2f}s", summary.speed_run_time / summary.speed_runs)
+                : "-"};
+        fmt::println("{:<20} {:>8} {:>10} {:>12.1f} {:>12.1f} {:>11.2f}s {:>12} {:>12}",
+                     algorithms[i], summary.runs, summary.finished, summary.steps / runs,
+                     summary.explored / runs, summary.time / runs, speed_run_time,
+                     summary.steps ? summary.step_ns / summary.steps : 0);
+    }
+}
+
+} // namespace Runner
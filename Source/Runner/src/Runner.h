@@ -0,0 +1,106 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <Core/Maze.h>
+#include <Core/Simulation.h>
+
+namespace Runner
+{
+
+/*! \brief Runs every algorithm on every maze using the headless Core::Simulation
+ *
+ *  Each (maze, algorithm) pair is ran as a separate job on the ThreadPool, where every job creates
+ * its own copy of the Maze and Mouse so nothing is shared between the workers.
+ *
+ *  In firmware mode the Firmware::Mouse2 control loop is ran instead, against the continuous
+ * Firmware::HAL::PhysicsHardware model of the Maze, to tune the firmware on many mazes.
+ */
+class MazeRunner
+{
+public:
+    //! Result of running a single algorithm on a single maze
+    struct Run
+    {
+        //! Index into the loaded mazes
+        size_t maze;
+        //! Index into the algorithms
+        size_t algorithm;
+        //! Result from the Core::Simulation
+        Core::Simulation::RunResult result;
+        //! Wall-clock time in nanoseconds spent in Core::Simulation::Step
+        uint64_t step_ns{0};
+        //! Virtual time in seconds of the speed run after finishing, if a route was explored
+        std::optional<double> speed_run_time{std::nullopt};
+        //! Error message if the simulation threw
+        std::string error{};
+    };
+
+    //! Summary of every Run of an algorithm
+    struct Summary
+    {
+        size_t runs{0};
+        size_t finished{0};
+        uint64_t steps{0};
+        uint64_t explored{0};
+        uint64_t step_ns{0};
+        double time{0.0};
+        size_t speed_runs{0};
+        double speed_run_time{0.0};
+    };
+
+    //! Create a runner stopping each run after \p max_steps
+    MazeRunner(uint64_t max_steps);
+
+    //! Load every maze file (*.txt, *.maze) inside of directory at \p path, or every maze in the
+    //! Core::MazeArchive at \p path
+    void LoadMazes(const std::filesystem::path &path);
+    //! Pack the loaded mazes into a Core::MazeArchive at \p path, returns the amount packed after
+    //! removing duplicates
+    size_t SaveArchive(const std::filesystem::path &path);
+    //! Save a Core::RunTrace of every run as `<maze>-<algorithm>.trace` into the directory at
+    //! \p path, recording is included in the step time
+    inline void SetTraceDirectory(std::filesystem::path path) { trace_directory = std::move(path); }
+    //! Run the firmware control loop with the physics model instead of Core::Simulation
+    inline void SetFirmware(bool firmware) noexcept { this->firmware = firmware; }
+    //! Use the \p algorithms, defaults to every algorithm in Core::AlgorithmRegistry
+    inline void SetAlgorithms(std::vector<std::string> algorithms)
+    {
+        this->algorithms = std::move(algorithms);
+    }
+
+    //! Run every maze and algorithm pair on \p threads, 0 uses every hardware thread
+    void RunAll(size_t threads = 0);
+
+    //! Print every run as CSV
+    void PrintRuns();
+    //! Print the summary per algorithm
+    void PrintSummary();
+
+    //! Get the results of the last RunAll
+    inline std::vector<Run> &GetRuns() noexcept { return runs; }
+
+private:
+    //! Run the \p algorithm on a copy of the \p maze
+    Run RunOne(size_t maze, size_t algorithm);
+    //! Run Firmware::Mouse2 with the \p algorithm inside of the physics model of the \p maze
+    Run RunFirmware(size_t maze, size_t algorithm);
+
+    uint64_t max_steps;
+    bool firmware{false};
+    //! Directory to save the traces into, empty to not trace
+    std::filesystem::path trace_directory;
+    //! Wall-clock time in nanoseconds of the last RunAll
+    uint64_t total_ns{0};
+    size_t threads_used{0};
+    std::vector<std::string> maze_names;
+    std::vector<std::unique_ptr<Core::Maze>> mazes;
+    std::vector<std::string> algorithms;
+    std::vector<Run> runs;
+};
+
+} // namespace Runner
@@ -0,0 +1,115 @@
+#include "ThreadPool.h"
+
+namespace Runner
+{
+
+ThreadPool::ThreadPool(size_t threads)
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (size_t i{0}; i < threads; ++i)
+        queues.push_back(std::make_unique<Queue>());
+
+    for (size_t i{0}; i < threads; ++i)
+        workers.emplace_back([this, i]() { Work(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{mutex};
+        quit = true;
+    }
+    work_available.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(Job job)
+{
+    pending++;
+
+    auto &queue{*queues[next_queue++ % queues.size()]};
+    {
+        std::lock_guard lock{queue.mutex};
+        queue.jobs.push_back(std::move(job));
+        queued++;
+    }
+
+    // Take the lock to avoid the wakeup being lost between a worker checking and parking
+    {
+        std::lock_guard lock{mutex};
+    }
+    work_available.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock lock{mutex};
+    work_done.wait(lock, [this]() { return pending == 0; });
+}
+
+bool ThreadPool::Take(size_t index, Job &job)
+{
+    // Newest job from own queue
+    {
+        auto &queue{*queues[index]};
+        std::lock_guard lock{queue.mutex};
+        if (!queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    // Steal the oldest job from the other queues
+    for (size_t i{1}; i < queues.size(); ++i)
+    {
+        auto &queue{*queues[(index + i) % queues.size()]};
+        std::lock_guard lock{queue.mutex};
+        if (!queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::Work(size_t index)
+{
+    Job job;
+    while (true)
+    {
+        if (Take(index, job))
+        {
+            job();
+            job = nullptr;
+
+            // Wake up Wait if this was the last job
+            if (--pending == 0)
+            {
+                std::lock_guard lock{mutex};
+                work_done.notify_all();
+            }
+            continue;
+        }
+
+        // Park until there is more work or quitting
+        std::unique_lock lock{mutex};
+        if (quit)
+            return;
+        work_available.wait(lock, [this]() { return quit || queued > 0; });
+        if (quit)
+            return;
+    }
+}
+
+} // namespace Runner
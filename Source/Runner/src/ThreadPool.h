@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Runner
+{
+
+/*! \brief Work-stealing pool of threads
+ *
+ *  Every worker has its own queue of jobs, jobs are taken from the back of the own queue and when
+ * it runs empty the worker steals from the front of the other workers queues
+ */
+class ThreadPool
+{
+public:
+    using Job = std::function<void()>;
+
+    //! Create a pool with \p threads workers, 0 uses the amount of hardware threads
+    ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    //! Submit a \p job, spread round robin over the worker queues
+    void Submit(Job job);
+    //! Block until every submitted job has been run
+    void Wait();
+
+    //! Get the amount of worker threads
+    inline size_t Size() noexcept { return workers.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    //! Main loop of worker at \p index
+    void Work(size_t index);
+    //! Get a job from own queue at \p index or steal one from the others
+    bool Take(size_t index, Job &job);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> next_queue{0};
+    //! Jobs submitted but not yet taken by a worker
+    std::atomic<size_t> queued{0};
+    //! Jobs submitted but not yet finished
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> quit{false};
+
+    // Used to park idle workers and wake up Wait
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+};
+
+} // namespace Runner
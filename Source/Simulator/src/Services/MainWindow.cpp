@@ -147,6 +147,8 @@ void MainWindow::DrawMenuBar()
                         &application->GetWindow(Windows::WindowId::RemoteConnections)->GetOpen());
         ImGui::MenuItem("Remote motor control", NULL,
                         &application->GetWindow(Windows::WindowId::RemoteMotors)->GetOpen());
+        ImGui::MenuItem("Profiler", NULL,
+                        &application->GetWindow(Windows::WindowId::Profiler)->GetOpen());
         ImGui::EndMenu();
     }
 
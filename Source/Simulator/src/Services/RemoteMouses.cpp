@@ -192,6 +192,24 @@ void RemoteMouse::UpdateControl()
 void RemoteMouse::Reset() { SendAction(BLE_STRUCTURE(MouseService, MouseAction)::Reset); }
 void RemoteMouse::Step() { SendAction(BLE_STRUCTURE(MouseService, MouseAction)::Step); }
 
+std::optional<BLE_STRUCTURE(MouseService, Profile)> RemoteMouse::ReadProfile()
+{
+    auto payload{peripheral.read(MICROBIT_BLE_SERVICE_CHARACTERISTIC(MouseService, Profile))};
+    if (payload.size() != sizeof(BLE_STRUCTURE(MouseService, Profile)))
+    {
+        LOG_ERROR("Incorrect size of Profile, got: {}, expected: {}", payload.size(),
+                  sizeof(BLE_STRUCTURE(MouseService, Profile)));
+        return std::nullopt;
+    }
+
+    return *(BLE_STRUCTURE(MouseService, Profile) *)payload.data();
+}
+
+void RemoteMouse::ClearProfile()
+{
+    SendAction(BLE_STRUCTURE(MouseService, MouseAction)::ClearProfile);
+}
+
 std::vector<std::string> &RemoteMouse::GetAlgorithms() { return algorithms; }
 
 void RemoteMouse::SetAlgorithm(size_t i)
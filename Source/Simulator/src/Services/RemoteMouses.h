@@ -3,6 +3,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 
 #include <Core/Comm.h>
 #include <Core/Mouse.h>
@@ -51,6 +52,11 @@ public:
         void SetAlgorithm(size_t i);
         inline Core::Maze *GetMaze() noexcept { return mouse->GetMaze(); };
 
+        //! Read the Core::Profiler statistics from the firmware
+        std::optional<BLE_STRUCTURE(MouseService, Profile)> ReadProfile();
+        //! Clear the Core::Profiler statistics on the firmware
+        void ClearProfile();
+
     private:
         void OnControlNotify(SimpleBLE::ByteArray data);
         void OnPositionNotify(SimpleBLE::ByteArray data);
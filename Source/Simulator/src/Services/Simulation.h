@@ -1,12 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <Core/Bitflags.h>
 #include <Core/Maze.h>
 #include <Core/Mouse.h>
+#include <Core/RunTrace.h>
+#include <Core/Simulation.h>
 
 #include "../SimulatorMouse.h"
 #include "Service.h"
@@ -15,6 +18,12 @@ namespace Simulator::Services
 {
 
 /*! \brief State and logic related to Simulation in Simulator
+ *
+ *  Wraps the headless Core::Simulation, only adding the wall-clock pacing used by the UI. Every
+ * step takes the virtual time estimated by the Core::MotionModel, scaled by the speed.
+ *
+ *  Every step is recorded to a Core::RunTrace, so the run can be scrubbed back to any earlier step
+ * and stepping continues from the latest step again.
  */
 class Simulation : public SimulatorMouse, public Service
 {
@@ -40,11 +49,22 @@ public:
     size_t GetAlgorithm();
     void SetAlgorithm(size_t i);
 
-    inline Core::Maze *GetMaze() { return maze.get(); };
+    inline Core::Maze *GetMaze() { return simulation ? simulation->GetMaze() : nullptr; };
+    //! Get the virtual time in seconds since reset
+    inline double GetTime() { return simulation ? simulation->GetTime() : 0.0; };
+    //! Get the wall-clock time in ms the last step is shown for
+    inline float GetStepTime() { return last_step_time; };
+
+    //! Get the amount of steps recorded since reset
+    inline uint32_t GetTraceSize() { return trace ? trace->Size() : 0; };
+    //! Get the step shown, which is GetTraceSize() unless scrubbing
+    inline uint32_t GetTraceStep() { return scrub_step.value_or(GetTraceSize()); };
+    //! Show the Mouse and its Maze as they were before \p step, GetTraceSize() shows the latest
+    void Scrub(uint32_t step);
 
     /* Just keep these public for simplicity */
-    //! Speed in steps per second
-    float speed{3.0f};
+    //! Speed relative to the virtual time, 1.0 is the estimated speed of the real Mouse
+    float speed{1.0f};
     //! X-value before last step
     float last_x;
     //! Y-value before last step
@@ -56,18 +76,20 @@ public:
 
 private:
     bool running{false};
+    //! Wall-clock time in ms of the last step
+    float last_step_time{0.0f};
     Application *application{nullptr};
-    std::unique_ptr<Core::Maze> maze{nullptr};
-    std::unique_ptr<Core::Mouse> mouse{nullptr};
+    std::unique_ptr<Core::Simulation> simulation{nullptr};
+    std::unique_ptr<Core::RunTrace> trace{nullptr};
+    //! Step shown while scrubbing
+    std::optional<uint32_t> scrub_step{std::nullopt};
+    //! Position and rotation of the Mouse at the latest step while scrubbing
+    float live_x;
+    float live_y;
+    float live_rot;
     std::vector<std::string> algorithms;
     size_t algorithm{0};
     size_t next_algorithm{0};
-    int width, height;
-
-    //! Trace using the Simulation in the Direction, return the hit MazeTile from the Mouse Maze
-    Core::MazeTile &TraceTile(Core::Direction direction, int x, int y);
-    //! Trace the 3 direction the MicroMouse can see and add it to the Mouse Maze
-    void TraceWalls(Core::Direction front_direction, int x, int y);
 };
 
 } // namespace Simulator::Services
@@ -70,7 +70,14 @@ public:
             auto simulation{dynamic_cast<Services::Simulation *>(simulator_mouse)};
 
             ImGui::SeparatorText("Simulation");
-            ImGui::DragFloat("Cycles/s", &simulation->speed, 0.1f, 0.0f, 20.0f);
+            ImGui::DragFloat("Speed", &simulation->speed, 0.1f, 0.1f, 20.0f, "%.1fx");
+            ImGui::Text("Time: %.2f s", simulation->GetTime());
+
+            // Scrub through the recorded steps
+            int step{static_cast<int>(simulation->GetTraceStep())};
+            if (ImGui::SliderInt("Trace", &step, 0, static_cast<int>(simulation->GetTraceSize()),
+                                 "Step %d"))
+                simulation->Scrub(static_cast<uint32_t>(step));
         }
 
         ImGui::End();
@@ -200,8 +200,8 @@ private:
         if (simulator_mouse->IsSimulation() && simulator_mouse->IsMoving())
         {
             auto simulation{dynamic_cast<Services::Simulation *>(simulator_mouse)};
-            // Calculate the estimated step time in ms
-            float step_time{1.0f / simulation->speed * 1000.0f};
+            // Get the estimated step time in ms
+            float step_time{simulation->GetStepTime()};
             // Calculate the progress between the start of step and end of step (0.0 - 1.0)
             float progress = ((SDL_GetTicks() - simulation->last_step) /
                               ((simulation->last_step + step_time) - simulation->last_step));
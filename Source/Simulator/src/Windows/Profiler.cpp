@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cfloat>
+#include <optional>
+
+#include <imgui.h>
+
+#include <Core/Comm.h>
+#include <Core/Profiler.h>
+
+#include "../Application.h"
+#include "../Services/RemoteMouses.h"
+#include "Window.h"
+
+using namespace Core;
+
+namespace Simulator::Windows
+{
+
+//! Show the Core::Profiler statistics read from the remote mouse
+class Profiler : public Window
+{
+public:
+    Profiler(Application *application) : application{application} {}
+
+    WINDOW(Profiler);
+
+    void Draw()
+    {
+        ImGui::SetNextWindowSize(ImVec2(500.0f, 640.0f));
+        ImGui::Begin("Profiler", NULL, ImGuiWindowFlags_NoResize);
+
+        auto remote_mouses{application->GetService<Services::RemoteMouses>()};
+        auto remote_mouse{remote_mouses->GetActiveRemoteMouse()};
+        if (!remote_mouse)
+        {
+            ImGui::Text("No remote mouse connected");
+            ImGui::End();
+            return;
+        }
+
+        if (ImGui::Button("Refresh") ||
+            (auto_refresh && ImGui::GetTime() - last_refresh > REFRESH_INTERVAL))
+            Refresh(remote_mouse);
+        ImGui::SameLine();
+        if (ImGui::Button("Clear"))
+        {
+            remote_mouse->ClearProfile();
+            Refresh(remote_mouse);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Auto-refresh", &auto_refresh);
+
+        if (!profile.has_value())
+        {
+            ImGui::End();
+            return;
+        }
+
+        bool recorded{std::any_of(profile->begin(), profile->end(),
+                                  [](auto &stats) { return stats.count > 0; })};
+        if (!recorded)
+            ImGui::TextDisabled("Nothing recorded, is the Firmware built with -DPROFILER=ON?");
+
+        for (size_t i{0}; i < Core::Profiler::PROBE_COUNT; ++i)
+        {
+            auto &stats{(*profile)[i]};
+            auto name{Core::Profiler::GetName(static_cast<Core::Profiler::Probe>(i))};
+
+            ImGui::PushID(i);
+            ImGui::SeparatorText(name.data());
+            if (stats.count == 0)
+            {
+                ImGui::Text("No calls");
+                ImGui::PopID();
+                continue;
+            }
+
+            ImGui::Text("Calls: %u, min: %.1f us, max: %.1f us", stats.count,
+                        Microseconds(stats.min), Microseconds(stats.max));
+
+            // Log2 histogram, bucket i is below 2^i cycles
+            float buckets[Core::Profiler::BUCKETS];
+            for (size_t b{0}; b < Core::Profiler::BUCKETS; ++b)
+                buckets[b] = stats.buckets[b];
+            ImGui::PlotHistogram("##histogram", buckets, Core::Profiler::BUCKETS, 0, NULL, 0.0f,
+                                 FLT_MAX, ImVec2(-FLT_MIN, 60.0f));
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Bucket i counts calls below 2^i cycles (%u cycles/us)",
+                                  Core::Profiler::CYCLES_PER_US);
+
+            ImGui::PopID();
+        }
+
+        ImGui::End();
+    }
+
+private:
+    //! Seconds between reads with auto-refresh
+    static constexpr double REFRESH_INTERVAL{1.0};
+
+    Application *application{nullptr};
+    std::optional<BLE_STRUCTURE(MouseService, Profile)> profile;
+    bool auto_refresh{false};
+    double last_refresh{0.0};
+
+    void Refresh(Services::RemoteMouses::RemoteMouse *remote_mouse)
+    {
+        last_refresh = ImGui::GetTime();
+
+        try
+        {
+            profile = remote_mouse->ReadProfile();
+        }
+        catch (const std::exception &e)
+        {
+            application->Error(e.what());
+            auto_refresh = false;
+        }
+    }
+
+    static float Microseconds(uint32_t cycles)
+    {
+        return static_cast<float>(cycles) / Core::Profiler::CYCLES_PER_US;
+    }
+};
+
+REGISTER_WINDOW(Profiler)
+
+} // namespace Simulator::Windows
@@ -20,7 +20,8 @@ enum class WindowId
     Maze,
     Controls,
     RemoteConnections,
-    RemoteMotors
+    RemoteMotors,
+    Profiler
 };
 
 //! Base abstract class for simulator windows